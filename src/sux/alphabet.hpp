@@ -10,6 +10,11 @@
 
 #include <type_traits>
 #include <iterator>
+#include <climits>
+#include <limits>
+#include <algorithm>
+#include <map>
+#include <vector>
 
 #include "../util/parallelization.hpp"
 
@@ -23,13 +28,194 @@ namespace rlx {
   template <AlphabetClass alphabetclass, typename Char = char, typename Freq = std::size_t>
   struct Alphabet;
 
+  /**
+   * Frequency table with one entry for every possible value of a
+   * (narrow) integer character type, stored in a flat array. The
+   * entries are arranged in the order of the characters, i.e. the
+   * values of signed character types are shifted so that the most
+   * negative character comes first.
+   */
+  template <typename Char, typename Freq>
+  class DenseFreqTable
+  {
+  public:
+    typedef typename std::make_unsigned<Char>::type uchar_type;
+    typedef typename std::vector<Freq>::iterator       iterator;
+    typedef typename std::vector<Freq>::const_iterator const_iterator;
+
+    static constexpr std::size_t char_bits = sizeof(Char) * CHAR_BIT;
+    static constexpr std::size_t num_chars = std::size_t(1) << char_bits;
+
+    DenseFreqTable()
+    : _freqs(num_chars)
+    { }
+
+    Freq &operator[](const Char c)
+    { return _freqs[index_of(c)]; }
+
+    const Freq &operator[](const Char c) const
+    { return _freqs[index_of(c)]; }
+
+    const Freq &at(const Char c) const
+    { return _freqs[index_of(c)]; }
+
+    std::size_t size() const
+    { return num_chars; }
+
+    iterator begin()
+    { return _freqs.begin(); }
+    iterator end()
+    { return _freqs.end(); }
+    const_iterator begin() const
+    { return _freqs.begin(); }
+    const_iterator end() const
+    { return _freqs.end(); }
+
+    /**
+     * Position of a character in the table.
+     */
+    static std::size_t index_of(const Char c)
+    { return (static_cast<std::size_t>(static_cast<uchar_type>(c)) ^ char_flip); }
+
+    /**
+     * The character stored at a given position of the table.
+     */
+    static Char char_at(const std::size_t index)
+    { return static_cast<Char>(static_cast<uchar_type>(index ^ char_flip)); }
+
+  private:
+    static constexpr std::size_t char_flip =
+        (std::is_signed<Char>::value ? (std::size_t(1) << (char_bits - 1)) : 0);
+
+    std::vector<Freq> _freqs;
+  };
+
+  namespace alphabet_tools {
+
+    /**
+     * Turn a list of per-thread frequency tables, each indexed by
+     * character in character order, into per-thread cumulative
+     * frequency tables: Afterwards, the entry of thread t for
+     * character c is the number of characters smaller than c
+     * (in all threads), plus the number of occurrences of c in threads
+     * 0..t-1. This is the write offset of thread t for bucket c.
+     *
+     * This is an exclusive scan over the thread x character matrix,
+     * in transposed order (characters in the outer loop, threads in the
+     * inner one). Large tables are split into contiguous character
+     * ranges, which are scanned in parallel: First the total of each
+     * range is determined, then all ranges are scanned, each starting
+     * from the sum of the totals of the preceding ranges.
+     */
+    template <typename FreqTable>
+    void make_thread_cumulative(std::vector<FreqTable> &tables, unsigned threads)
+    {
+      using std::distance;
+      using std::make_tuple;
+      using rlxutil::parallel::tools::arg_generator;
+      using rlxutil::parallel::tools::wait_for;
+
+      typedef typename std::remove_reference<decltype(*tables.front().begin())>::type freq_type;
+      typedef decltype(tables.front().begin()) It;
+
+      if (tables.empty())
+        return;
+
+      /* Portions of the character range. Tables up to the minimum
+       * portion size are handled by a single thread. */
+      rlxutil::parallel::portions portions
+      { tables.front().begin(), tables.front().end(), threads, 4096 };
+      const It start
+      { tables.front().begin() };
+
+      /* Total frequency of each character range. */
+      auto total_futs = portions.apply(tables.front().begin(),tables.front().end(),
+          [start,&tables](It from, It to)
+          {
+            const std::size_t first = distance(start,from);
+            const std::size_t last  = distance(start,to);
+            freq_type total
+            { 0 };
+            for (const FreqTable &table : tables)
+              {
+                auto it = table.begin();
+                for (std::size_t c = first ; c < last ; ++c)
+                  total += *(it + c);
+              }
+            return total;
+          });
+
+      /* Starting offset of each character range. */
+      std::vector<freq_type> range_offsets
+      { };
+      freq_type total
+      { 0 };
+      for (auto &total_fut : total_futs)
+        {
+          range_offsets.push_back(total);
+          total += total_fut.get();
+        }
+
+      /* Scan all character ranges. */
+      auto scan_futs = portions.apply_dynargs(tables.front().begin(),tables.front().end(),
+          [start,&tables](It from, It to, freq_type offset)
+          {
+            const std::size_t first = distance(start,from);
+            const std::size_t last  = distance(start,to);
+            for (std::size_t c = first ; c < last ; ++c)
+              for (FreqTable &table : tables)
+                {
+                  freq_type &freq = *(table.begin() + c);
+                  const freq_type count = freq;
+                  freq    = offset;
+                  offset += count;
+                }
+          },
+          arg_generator([&range_offsets](std::size_t range)
+          { return make_tuple(range_offsets[range]); }));
+      wait_for(scan_futs);
+    }
+
+  }
+
+  /**
+   * True if the frequency tables of a sparse alphabet over
+   * `Char` are `DenseFreqTable`s rather than maps. This is the case
+   * for integer characters of at most 16 bits.
+   */
+  template <typename Char>
+  struct use_dense_freq_table : std::integral_constant<bool,
+    (std::is_integral<Char>::value
+        && !std::is_same<Char,bool>::value
+        && (sizeof(Char) * CHAR_BIT <= 16))>
+  { };
+
+  /**
+   * An alphabet of characters that occupy an arbitrary subset of
+   * the values of `Char`. For narrow integer types, frequency
+   * tables are flat arrays indexed by the character; for all other
+   * types, they are maps that hold the characters that actually
+   * occur.
+   */
   template <typename Char, typename Freq>
   struct Alphabet<AlphabetClass::sparse,Char,Freq>
   {
     typedef Char                 char_type;
     typedef Freq                 freq_type;
     typedef std::pair<Char,Freq> char_freq_type;
-    typedef std::map<Char,Freq>  freq_table_type;
+    typedef use_dense_freq_table<Char> is_dense;
+    typedef typename std::conditional<is_dense::value,
+        DenseFreqTable<Char,Freq>,
+        std::map<Char,Freq>>::type freq_table_type;
+
+    /**
+     * True if the frequency tables are arrays, and `bucket_index()`
+     * gives the position of each character in them.
+     */
+    static constexpr bool indexed_freq_table = is_dense::value;
+
+    static std::size_t bucket_index(const Char c)
+    { return freq_table_type::index_of(c); }
 
     /**
      * Create a new frequency table with all character counts set to 0.
@@ -43,10 +229,7 @@ namespace rlx {
      */
     static void add_char_freq_table(
         freq_table_type &main_table, const freq_table_type &add_table, unsigned)
-    {
-      for (const char_freq_type &entry : add_table)
-        main_table[entry.first] += entry.second;
-    }
+    { add_freqs(main_table,add_table,is_dense()); }
 
     /**
      * Turn a character frequency table into a cumulative character
@@ -59,14 +242,99 @@ namespace rlx {
       freq_type total
       { 0 };
       for (auto &entry : freq_table) {
-        std::swap(total,entry.second);
-        total += entry.second;
+        std::swap(total,freq_of(entry));
+        total += freq_of(entry);
       }
     }
+
+    /**
+     * Turn the frequency tables of several threads into cumulative
+     * tables that provide the write offset of each thread for each
+     * character (see `alphabet_tools::make_thread_cumulative()`).
+     */
+    static void make_cumulative(std::vector<freq_table_type> &freq_tables, unsigned threads)
+    { make_thread_cumulative(freq_tables,threads,is_dense()); }
+
+    /**
+     * Call `fun(character,frequency)` for every character with
+     * non-zero frequency in the table, in lexicographical order.
+     */
+    template <typename Fun>
+    static void for_each_char(const freq_table_type &freq_table, Fun fun)
+    { visit_chars(freq_table,fun,is_dense()); }
+
+  private:
+    static freq_type &freq_of(char_freq_type &entry)
+    { return entry.second; }
+    static freq_type &freq_of(std::pair<const Char,Freq> &entry)
+    { return entry.second; }
+    static freq_type &freq_of(freq_type &freq)
+    { return freq; }
+
+    static void add_freqs(
+        freq_table_type &main_table, const freq_table_type &add_table, std::false_type)
+    {
+      for (const char_freq_type &entry : add_table)
+        main_table[entry.first] += entry.second;
+    }
+
+    static void add_freqs(
+        freq_table_type &main_table, const freq_table_type &add_table, std::true_type)
+    {
+      auto src_it = add_table.begin();
+      for (freq_type &freq : main_table)
+        freq += *src_it++;
+    }
+
+    static void make_thread_cumulative(
+        std::vector<freq_table_type> &freq_tables, unsigned threads, std::true_type)
+    { alphabet_tools::make_thread_cumulative(freq_tables,threads); }
+
+    /**
+     * Maps cannot be scanned by index, because each thread's table
+     * contains only the characters seen by that thread. Instead, the
+     * total table is made cumulative and then added thread by thread.
+     */
+    static void make_thread_cumulative(
+        std::vector<freq_table_type> &freq_tables, unsigned threads, std::false_type)
+    {
+      freq_table_type cumul_table
+      { };
+      for (const freq_table_type &table : freq_tables)
+        add_char_freq_table(cumul_table,table,threads);
+      make_cumulative(cumul_table);
+      for (freq_table_type &table : freq_tables)
+        {
+          std::swap(cumul_table,table);
+          add_char_freq_table(cumul_table,table,threads);
+        }
+    }
+
+    template <typename Fun>
+    static void visit_chars(const freq_table_type &freq_table, Fun &fun, std::false_type)
+    {
+      for (const char_freq_type &entry : freq_table)
+        if (entry.second != 0)
+          fun(entry.first,entry.second);
+    }
+
+    template <typename Fun>
+    static void visit_chars(const freq_table_type &freq_table, Fun &fun, std::true_type)
+    {
+      for (std::size_t index = 0 ; index < freq_table.size() ; ++index)
+        {
+          const Char c
+          { freq_table_type::char_at(index) };
+          if (freq_table[c] != 0)
+            fun(c,freq_table[c]);
+        }
+    }
   };
 
   /**
-   * A continuous integer alphabet from (Char)0 to _highest.
+   * A continuous integer alphabet from (Char)0 to _highest (exclusive).
+   * `_highest` is stored as `std::size_t`, so that an alphabet can
+   * cover the entire range of `Char`.
    */
   template <typename Char, typename Freq>
   struct Alphabet<AlphabetClass::zero_range,Char,Freq>
@@ -74,9 +342,9 @@ namespace rlx {
     static_assert(std::is_integral<Char>::value,
         "A zero-range alphabet must be an integer alphabet");
 
-    Char _highest;
+    std::size_t _highest;
 
-    constexpr Alphabet(const Char highest)
+    constexpr Alphabet(const std::size_t highest)
     : _highest(highest)
     { }
 
@@ -84,11 +352,20 @@ namespace rlx {
     typedef Freq               freq_type;
     typedef std::vector<Freq>  freq_table_type;
 
+    /**
+     * The frequency tables are arrays, and `bucket_index()` gives
+     * the position of each character in them.
+     */
+    static constexpr bool indexed_freq_table = true;
+
+    static std::size_t bucket_index(const Char c)
+    { return static_cast<std::size_t>(c); }
+
     /**
      * Create a new frequency table with all character counts set to 0.
      */
     freq_table_type new_freq_table() const
-    { return freq_table_type(static_cast<std::size_t>(_highest)); }
+    { return freq_table_type(_highest); }
 
     /**
      * Adding the character frequencies of the second frequency
@@ -107,11 +384,11 @@ namespace rlx {
       const It start
       { main_table.begin() };
 
-      portions.apply
-      ([start,&add_table](It from, It to)
+      auto futs = portions.apply
+      (begin(main_table),end(main_table),
+       [start,&add_table](It from, It to)
       {
-        It src_it
-        { add_table.begin() + distance(start,from) };
+        auto src_it = add_table.begin() + distance(start,from);
 
         while (from != to)
           {
@@ -120,6 +397,8 @@ namespace rlx {
             ++src_it;
           }
       });
+
+      rlxutil::parallel::tools::wait_for(futs);
     }
 
     /**
@@ -137,6 +416,26 @@ namespace rlx {
         total += freq;
       }
     }
+
+    /**
+     * Turn the frequency tables of several threads into cumulative
+     * tables that provide the write offset of each thread for each
+     * character (see `alphabet_tools::make_thread_cumulative()`).
+     */
+    static void make_cumulative(std::vector<freq_table_type> &freq_tables, unsigned threads)
+    { alphabet_tools::make_thread_cumulative(freq_tables,threads); }
+
+    /**
+     * Call `fun(character,frequency)` for every character with
+     * non-zero frequency in the table, in lexicographical order.
+     */
+    template <typename Fun>
+    static void for_each_char(const freq_table_type &freq_table, Fun fun)
+    {
+      for (std::size_t c = 0 ; c < freq_table.size() ; ++c)
+        if (freq_table[c] != 0)
+          fun(static_cast<Char>(c),freq_table[c]);
+    }
   };
 
   namespace alphabet_tools {
@@ -154,6 +453,129 @@ namespace rlx {
       });
       return freq_table;
     }
+
+    /**
+     * The character type used for a text whose alphabet has been
+     * compacted by `compact_alphabet()`: The unsigned version of the
+     * original character type if it is an integer type (the number of
+     * distinct characters never exceeds its range), `Pos` otherwise.
+     */
+    template <typename Char, typename Pos>
+    using compact_char_type =
+        typename std::conditional<std::is_integral<Char>::value,
+          std::make_unsigned<Char>,
+          std::common_type<Pos>>::type::type;
+
+    /**
+     * Determine the set of characters that occur in [from,to), and
+     * replace each character by its rank among them. The rank
+     * preserves the order of characters, and the result is a text
+     * over the zero-range alphabet [0,sigma), where sigma is the
+     * number of distinct characters. Both the counting and the
+     * rewriting are performed by `threads` parallel threads.
+     *
+     * @return The rewritten text and the zero-range alphabet it uses.
+     */
+    template <typename Pos, typename It>
+    std::pair<
+      std::vector<compact_char_type<typename std::remove_cv<rlxtype::deref<It>>::type,Pos>>,
+      Alphabet<AlphabetClass::zero_range,
+        compact_char_type<typename std::remove_cv<rlxtype::deref<It>>::type,Pos>,Pos>>
+    compact_alphabet(It from, It to, unsigned threads)
+    {
+      using std::distance;
+      using rlxutil::parallel::tools::wait_for;
+
+      typedef typename std::remove_cv<rlxtype::deref<It>>::type char_type;
+      typedef compact_char_type<char_type,Pos>                  rank_type;
+      typedef Alphabet<AlphabetClass::sparse,char_type,Pos>     count_alphabet_type;
+      typedef Alphabet<AlphabetClass::sparse,char_type,rank_type> rank_alphabet_type;
+      typedef Alphabet<AlphabetClass::zero_range,rank_type,Pos> result_alphabet_type;
+
+      const count_alphabet_type count_alphabet
+      { };
+      const rank_alphabet_type rank_alphabet
+      { };
+      auto char_id = [](const char_type c) { return c; };
+
+      rlxutil::parallel::portions portions
+      { from, to, threads };
+
+      /* Count characters. */
+      auto count_futs = portions.apply(from,to,
+          make_freq_table<It,decltype(char_id),count_alphabet_type>,char_id,count_alphabet);
+      auto counts = count_alphabet.new_freq_table();
+      for (auto &count_fut : count_futs)
+        count_alphabet_type::add_char_freq_table(counts,count_fut.get(),portions.threads());
+
+      /* Assign ranks in character order. */
+      auto ranks = rank_alphabet.new_freq_table();
+      std::size_t sigma
+      { 0 };
+      count_alphabet_type::for_each_char(counts,
+          [&ranks,&sigma](const char_type c, Pos)
+          { ranks[c] = static_cast<rank_type>(sigma++); });
+
+      /* Rewrite the text. */
+      std::vector<rank_type> result(distance(from,to));
+      const auto &const_ranks = ranks;
+      auto rewrite_futs = portions.apply(from,to,
+          [from,&result,&const_ranks](It local_from, It local_to)
+          {
+            auto dest = result.begin() + distance(from,local_from);
+            while (local_from != local_to)
+              *dest++ = const_ranks.at(*local_from++);
+          });
+      wait_for(rewrite_futs);
+
+      return { std::move(result) , result_alphabet_type(sigma) };
+    }
+
+    /**
+     * Compact the alphabet of [from,to) as `compact_alphabet()` does, then
+     * shift the ranks to [1,sigma] and append `padding` 0-characters, which
+     * serve as sentinels smaller than any character of the text. If the
+     * compact character type is too narrow to represent sigma, the text is
+     * widened to `Pos`. The text is passed to `fun(text,length,sigma)`,
+     * where `length` is the length without padding, and the result of
+     * `fun` is returned.
+     */
+    template <typename Pos, typename It, typename Fun>
+    auto with_sentinel_text(It from, It to, std::size_t padding, unsigned threads, Fun fun)
+    -> decltype(fun(std::declval<const std::vector<Pos> &>(),std::size_t(),std::size_t()))
+    {
+      using rlxutil::parallel::tools::wait_for;
+
+      auto compacted = compact_alphabet<Pos>(from,to,threads);
+      auto &text               = compacted.first;
+      const std::size_t sigma  = compacted.second._highest;
+      const std::size_t length = text.size();
+
+      typedef typename std::remove_reference<decltype(text)>::type text_type;
+      typedef typename text_type::value_type                       rank_type;
+      typedef typename text_type::iterator                         textit;
+
+      if (sigma < static_cast<std::size_t>(std::numeric_limits<rank_type>::max()))
+        {
+          rlxutil::parallel::portions portions
+          { text.begin() , text.end() , threads };
+          auto futs = portions.apply(text.begin(),text.end(),
+              [](textit local_from, textit local_to)
+              {
+                while (local_from != local_to)
+                  ++*local_from++;
+              });
+          wait_for(futs);
+          text.resize(length + padding,0);
+          return fun(static_cast<const text_type &>(text),length,sigma);
+        }
+
+      std::vector<Pos> wide_text(length + padding,0);
+      std::transform(text.begin(),text.end(),wide_text.begin(),
+          [](rank_type c) { return static_cast<Pos>(c) + 1; });
+      text = text_type();
+      return fun(static_cast<const std::vector<Pos> &>(wide_text),length,sigma);
+    }
   }
 
 }
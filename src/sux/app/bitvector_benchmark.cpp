@@ -0,0 +1,136 @@
+/*
+ * bitvector_benchmark.cpp
+ *
+ * Query time of rank and select on a large bit vector.
+ *
+ *   bitvector_benchmark [-t threads] [-n bits] [-d density] [-q queries]
+ *
+ * Builds a bit vector of 10^9 bits (by default) in which each bit is
+ * set with the given probability (0.5 by default), and prints the
+ * construction time, the space taken by the rank directory and the
+ * select samples relative to the bits, and the average time per query
+ * of rank1, select1 and select0 at random positions and ranks.
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glog/logging.h>
+
+#include "../bitvector.hpp"
+
+using rlxalgo::succinct::bitvector;
+
+/**
+ * A pseudo-random value for every position (splitmix64), so the bits
+ * can be generated by parallel threads.
+ */
+std::uint64_t hash(std::uint64_t pos)
+{
+  pos += 0x9e3779b97f4a7c15ULL;
+  pos = (pos ^ (pos >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  pos = (pos ^ (pos >> 27)) * 0x94d049bb133111ebULL;
+  return pos ^ (pos >> 31);
+}
+
+/**
+ * The average time in nanoseconds of `query(arg)` over all arguments.
+ */
+template <typename Query>
+double time_queries(const std::vector<std::size_t> &args, Query query)
+{
+  typedef std::chrono::steady_clock clock;
+
+  std::size_t total
+  { 0 };
+  auto tp1 = clock::now();
+  for (const std::size_t arg : args)
+    total += query(arg);
+  auto tp2 = clock::now();
+  /* Keep the queries from being optimised away. */
+  if (total == 0)
+    std::cerr << "All query results are 0" << std::endl;
+  return std::chrono::duration<double,std::nano>(tp2 - tp1).count() / args.size();
+}
+
+std::vector<std::size_t> random_args(std::size_t num, std::size_t limit)
+{
+  std::mt19937_64 gen
+  { 1 };
+  std::uniform_int_distribution<std::size_t> dist
+  { 0 , limit - 1 };
+  std::vector<std::size_t> result(num);
+  for (auto &arg : result)
+    arg = dist(gen);
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  using std::setw;
+  typedef std::chrono::steady_clock clock;
+
+  google::InitGoogleLogging(argv[0]);
+
+  unsigned threads
+  { 4 };
+  std::size_t size
+  { 1000000000 };
+  double density
+  { 0.5 };
+  std::size_t queries
+  { 10000000 };
+  for (int i = 1 ; i < argc ; ++i)
+    {
+      if (std::strcmp(argv[i],"-t") == 0 && i + 1 < argc)
+        threads = static_cast<unsigned>(std::atoi(argv[++i]));
+      else if (std::strcmp(argv[i],"-n") == 0 && i + 1 < argc)
+        size = static_cast<std::size_t>(std::atof(argv[++i]));
+      else if (std::strcmp(argv[i],"-d") == 0 && i + 1 < argc)
+        density = std::atof(argv[++i]);
+      else if (std::strcmp(argv[i],"-q") == 0 && i + 1 < argc)
+        queries = static_cast<std::size_t>(std::atol(argv[++i]));
+      else
+        {
+          std::cerr << "Unknown option " << argv[i] << std::endl;
+          return 1;
+        }
+    }
+
+  const std::uint64_t threshold
+  { static_cast<std::uint64_t>(density * 18446744073709551615.0) };
+  auto tp1 = clock::now();
+  const bitvector bits
+  { size , [threshold](std::size_t pos) { return hash(pos) < threshold; } , threads };
+  auto tp2 = clock::now();
+
+  const double bits_bytes
+  { static_cast<double>(size) / 8 };
+  std::cout << "Bits: " << size << ", set: " << bits.ones()
+      << ", construction: " << std::chrono::duration_cast<std::chrono::milliseconds>(tp2 - tp1).count()
+      << " ms, overhead: " << std::fixed << std::setprecision(1)
+      << 100.0 * (bits.size_in_bytes() - bits_bytes) / bits_bytes << "%" << std::endl;
+
+  std::cout << setw(10) << "query" << setw(12) << "ns/query" << std::endl;
+  std::cout << setw(10) << "rank1" << setw(12)
+      << time_queries(random_args(queries,size + 1),
+          [&bits](std::size_t pos) { return bits.rank1(pos); }) << std::endl;
+  if (bits.ones() > 0)
+    std::cout << setw(10) << "select1" << setw(12)
+        << time_queries(random_args(queries,bits.ones()),
+            [&bits](std::size_t rank) { return bits.select1(rank); }) << std::endl;
+  if (bits.zeros() > 0)
+    std::cout << setw(10) << "select0" << setw(12)
+        << time_queries(random_args(queries,bits.zeros()),
+            [&bits](std::size_t rank) { return bits.select0(rank); }) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * sa_benchmark.cpp
+ *
+ * Head-to-head comparison of the suffix array construction engines.
+ *
+ *   sa_benchmark [-t threads] [file...]
+ *
+ * Builds the suffix array of each file with every engine, prints the
+ * time taken and verifies that the results agree. Then builds the LCP
+ * array from the suffix array, with the full and the sparse PLCP
+ * algorithm. Without files, a random text of 32m characters is used.
+ *
+ * For each step, the growth of the peak resident memory of the process
+ * during that step is shown, i.e. the working memory and the result.
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <malloc.h>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../lcp.hpp"
+#include "../../util/proctime.hpp"
+#include "../../util/random.hpp"
+
+typedef unsigned int                             pos_type;
+typedef std::chrono::duration<double,std::milli> MS;
+
+/**
+ * Return free heap memory to the system, and reset the peak resident
+ * memory of the process to its current value.
+ * This requires Linux 4.0 or later; if it is not supported, the peak
+ * values shown are those since the start of the process.
+ */
+void reset_peak_memory()
+{
+  ::malloc_trim(0);
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+/**
+ * The value of the given field of /proc/self/status (e.g. the current
+ * or the peak resident memory), converted from KiB to MiB.
+ */
+double memory_status(const char *field)
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  const std::size_t field_len
+  { std::strlen(field) };
+  while (std::getline(status,line))
+    if (line.compare(0,field_len,field) == 0)
+      return std::atof(line.c_str() + field_len) / 1024.0;
+  return 0.0;
+}
+
+/**
+ * Run `fun` and print the time it takes and how much the peak memory
+ * grows beyond the memory in use before.
+ */
+template <typename Fun>
+auto measure(const char *name, Fun fun) -> decltype(fun())
+{
+  using std::setw;
+
+  reset_peak_memory();
+  const double start_memory
+  { memory_status("VmRSS:") };
+  auto tp1 = rlxutil::combined_clock<std::micro>::now();
+  auto result = fun();
+  auto tp2 = rlxutil::combined_clock<std::micro>::now();
+
+  std::cout << setw(18) << name << setw(10)
+      << std::chrono::duration_cast<MS>(tp2 - tp1) << "  peak +"
+      << static_cast<long>(memory_status("VmHWM:") - start_memory) << " MiB" << std::endl;
+  return result;
+}
+
+template <rlxalgo::SAEngine engine>
+std::vector<pos_type> run(const char *name, const std::string &text, unsigned threads)
+{
+  return measure(name,[&text,threads]()
+      { return rlxalgo::make_suffix_array<pos_type,engine>(text.begin(),text.end(),threads); });
+}
+
+bool benchmark(const std::string &label, const std::string &text, unsigned threads)
+{
+  using std::setw;
+  using rlxalgo::SAEngine;
+
+  std::cout << setw(18) << "Input:" << ' ' << label << " ("
+      << text.size() << " characters, " << threads << " threads)" << std::endl;
+
+  auto skew_sa = run<SAEngine::skew>("Skew (DC3):",text,threads);
+  auto sais_sa = run<SAEngine::sais>("SA-IS:",text,threads);
+
+  if (skew_sa != sais_sa)
+    {
+      std::cerr << "Suffix arrays differ for " << label << std::endl;
+      return false;
+    }
+  sais_sa = std::vector<pos_type>();
+
+  auto phi_lcp = measure("LCP (Phi):",[&text,&skew_sa,threads]()
+      { return rlxalgo::lcp::make_lcp_array_phi(text.begin(),text.end(),skew_sa,threads); });
+  auto sparse_lcp = measure("LCP (sparse):",[&text,&skew_sa,threads]()
+      { return rlxalgo::lcp::make_lcp_array_sparse(text.begin(),text.end(),skew_sa,threads); });
+
+  if (phi_lcp != sparse_lcp)
+    {
+      std::cerr << "LCP arrays differ for " << label << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  google::InitGoogleLogging(argv[0]);
+
+  unsigned threads
+  { 4 };
+  std::vector<std::string> files;
+  for (int i = 1 ; i < argc ; ++i)
+    {
+      if (std::strcmp(argv[i],"-t") == 0 && i + 1 < argc)
+        threads = static_cast<unsigned>(std::atoi(argv[++i]));
+      else
+        files.push_back(argv[i]);
+    }
+
+  bool ok
+  { true };
+  if (files.empty())
+    {
+      constexpr std::size_t N = 32 * 1024 * 1024;
+      std::string text;
+      text.resize(N);
+      std::generate_n(begin(text),N,
+          rlxutil::RandomSequenceGeneratorUniform<char>('a','z'));
+      ok = benchmark("random",text,threads);
+    }
+
+  for (const auto &file : files)
+    {
+      std::ifstream in(file,std::ios::binary);
+      if (!in)
+        {
+          std::cerr << "Cannot open " << file << std::endl;
+          return 1;
+        }
+      std::string text
+      { std::istreambuf_iterator<char>(in) , std::istreambuf_iterator<char>() };
+      ok = benchmark(file,text,threads) && ok;
+    }
+
+  return (ok ? 0 : 1);
+}
@@ -0,0 +1,240 @@
+/*
+ * search_benchmark.cpp
+ *
+ * Query latency of suffix array pattern search.
+ *
+ *   search_benchmark [-t threads] [-q queries] [-k k] [file]
+ *
+ * Builds the suffix array and LCP array of the file (or of a random
+ * text of 16m characters), then counts the occurrences of patterns
+ * taken from random text positions, for a range of pattern lengths.
+ * For each length, the median (p50) and 99th percentile (p99) of the
+ * latency per query are printed, for the plain mlr binary search, for
+ * the LCP-accelerated search and for the search that starts with a
+ * lookup in a k-mer table (k=3 by default), and for the backward
+ * search of the FM-index (`fm`). Finally, the throughput
+ * of searching all patterns of each length one by one is compared to
+ * that of a batch search (`find_batch()`), and the time per located
+ * occurrence and the size of compressed suffix arrays with several
+ * sampling rates are printed.
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../lcp.hpp"
+#include "../search.hpp"
+#include "../fm_index.hpp"
+#include "../sampled_sa.hpp"
+#include "../../util/random.hpp"
+
+typedef unsigned int pos_type;
+
+/**
+ * Count the occurrences of each pattern and return the latencies of
+ * the queries in nanoseconds, sorted.
+ */
+template <typename Searcher>
+std::vector<double> latencies(const Searcher &searcher, const std::vector<std::string> &patterns)
+{
+  typedef std::chrono::steady_clock clock;
+
+  std::vector<double> result;
+  result.reserve(patterns.size());
+  pos_type total
+  { 0 };
+  for (const auto &pattern : patterns)
+    {
+      auto tp1 = clock::now();
+      total += searcher.count(pattern);
+      auto tp2 = clock::now();
+      result.push_back(std::chrono::duration<double,std::nano>(tp2 - tp1).count());
+    }
+  /* Keep the queries from being optimised away. */
+  if (total == 0)
+    std::cerr << "No occurrences found" << std::endl;
+  std::sort(begin(result),end(result));
+  return result;
+}
+
+void print_percentiles(const char *name, const std::vector<double> &sorted)
+{
+  using std::setw;
+  std::cout << setw(8) << name
+      << setw(10) << static_cast<long>(sorted[sorted.size() / 2])
+      << setw(10) << static_cast<long>(sorted[sorted.size() * 99 / 100]);
+}
+
+/**
+ * The average time per pattern, in nanoseconds, of searching all
+ * patterns one by one and as a batch.
+ */
+template <typename Searcher>
+std::pair<double,double> throughput(const Searcher &searcher, const std::vector<std::string> &patterns)
+{
+  typedef std::chrono::steady_clock clock;
+
+  pos_type single_total
+  { 0 };
+  auto tp1 = clock::now();
+  for (const auto &pattern : patterns)
+    single_total += searcher.count(pattern);
+  auto tp2 = clock::now();
+  auto intervals = searcher.find_batch(patterns);
+  auto tp3 = clock::now();
+
+  pos_type batch_total
+  { 0 };
+  for (const auto &interval : intervals)
+    batch_total += interval.size();
+  if (single_total != batch_total)
+    std::cerr << "Batch search results differ" << std::endl;
+
+  return { std::chrono::duration<double,std::nano>(tp2 - tp1).count() / patterns.size() ,
+    std::chrono::duration<double,std::nano>(tp3 - tp2).count() / patterns.size() };
+}
+
+void benchmark(const std::string &label, const std::string &text,
+    unsigned threads, std::size_t queries, unsigned k)
+{
+  using std::setw;
+
+  std::cout << "Input: " << label << " (" << text.size() << " characters)" << std::endl;
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),threads);
+  auto lcp       = rlxalgo::lcp::make_lcp_array(text.begin(),text.end(),sux_array,threads);
+  auto mlr_searcher = rlxalgo::search::make_searcher(text,sux_array);
+  auto lcp_searcher = rlxalgo::search::make_searcher(text,sux_array,lcp);
+  auto kmer_searcher = rlxalgo::search::make_searcher(text,sux_array);
+  kmer_searcher.make_kmer_table(k,threads);
+  const rlxalgo::fm::fm_index<char,pos_type> index
+  { text.begin() , text.end() , sux_array , threads };
+  std::cout << "Text + SA: " << (text.size() * (1 + sizeof(pos_type))) / (1024 * 1024)
+      << " MiB, FM-index: " << index.size_in_bytes() / (1024 * 1024) << " MiB" << std::endl;
+
+  std::cout << setw(8) << "length"
+      << setw(8) << "" << setw(10) << "p50 ns" << setw(10) << "p99 ns"
+      << setw(8) << "" << setw(10) << "p50 ns" << setw(10) << "p99 ns"
+      << setw(8) << "" << setw(10) << "p50 ns" << setw(10) << "p99 ns"
+      << setw(8) << "" << setw(10) << "p50 ns" << setw(10) << "p99 ns" << std::endl;
+
+  std::mt19937 gen
+  { 1 };
+  std::vector<std::vector<std::string>> pattern_sets;
+  for (std::size_t length : { 2 , 4 , 8 , 16 , 32 , 64 , 128 , 256 })
+    {
+      if (length > text.size())
+        break;
+      std::uniform_int_distribution<std::size_t> dist
+      { 0 , text.size() - length };
+      pattern_sets.emplace_back();
+      std::vector<std::string> &patterns = pattern_sets.back();
+      for (std::size_t i = 0 ; i < queries ; ++i)
+        patterns.push_back(text.substr(dist(gen),length));
+
+      std::cout << setw(8) << length;
+      print_percentiles("mlr",latencies(mlr_searcher,patterns));
+      print_percentiles("lcp",latencies(lcp_searcher,patterns));
+      print_percentiles("kmer",latencies(kmer_searcher,patterns));
+      print_percentiles("fm",latencies(index,patterns));
+      std::cout << std::endl;
+    }
+
+  std::cout << setw(8) << "length" << setw(14) << "single ns/q" << setw(14) << "batch ns/q" << std::endl;
+  for (const auto &patterns : pattern_sets)
+    {
+      const std::pair<double,double> times
+      { throughput(mlr_searcher,patterns) };
+      std::cout << setw(8) << patterns.front().size()
+          << setw(14) << static_cast<long>(times.first)
+          << setw(14) << static_cast<long>(times.second) << std::endl;
+    }
+
+  /* Locate the occurrences of the patterns of length 8, which are
+   * rare in most texts. */
+  auto locate_patterns = std::find_if(pattern_sets.begin(),pattern_sets.end(),
+      [](const std::vector<std::string> &patterns) { return patterns.front().size() >= 8; });
+  if (locate_patterns == pattern_sets.end())
+    return;
+  std::cout << setw(8) << "rate" << setw(10) << "MiB" << setw(14) << "ns/occ" << std::endl;
+  for (pos_type rate : { 4 , 16 , 64 })
+    {
+      typedef std::chrono::steady_clock clock;
+
+      const rlxalgo::fm::sampled_suffix_array<char,pos_type> csa
+      { text.begin() , text.end() , sux_array , rate , threads };
+      std::size_t occurrences
+      { 0 };
+      auto tp1 = clock::now();
+      for (const auto &pattern : *locate_patterns)
+        occurrences += csa.locate(pattern).size();
+      auto tp2 = clock::now();
+      std::cout << setw(8) << rate
+          << setw(10) << csa.size_in_bytes() / (1024 * 1024)
+          << setw(14) << static_cast<long>(
+              std::chrono::duration<double,std::nano>(tp2 - tp1).count() / occurrences)
+          << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+  google::InitGoogleLogging(argv[0]);
+
+  unsigned threads
+  { 4 };
+  std::size_t queries
+  { 100000 };
+  unsigned k
+  { 3 };
+  std::vector<std::string> files;
+  for (int i = 1 ; i < argc ; ++i)
+    {
+      if (std::strcmp(argv[i],"-t") == 0 && i + 1 < argc)
+        threads = static_cast<unsigned>(std::atoi(argv[++i]));
+      else if (std::strcmp(argv[i],"-q") == 0 && i + 1 < argc)
+        queries = static_cast<std::size_t>(std::atol(argv[++i]));
+      else if (std::strcmp(argv[i],"-k") == 0 && i + 1 < argc)
+        k = static_cast<unsigned>(std::atoi(argv[++i]));
+      else
+        files.push_back(argv[i]);
+    }
+
+  if (files.empty())
+    {
+      constexpr std::size_t N = 16 * 1024 * 1024;
+      std::string text;
+      text.resize(N);
+      std::generate_n(begin(text),N,
+          rlxutil::RandomSequenceGeneratorUniform<char>('a','z'));
+      benchmark("random",text,threads,queries,k);
+    }
+
+  for (const auto &file : files)
+    {
+      std::ifstream in(file,std::ios::binary);
+      if (!in)
+        {
+          std::cerr << "Cannot open " << file << std::endl;
+          return 1;
+        }
+      std::string text
+      { std::istreambuf_iterator<char>(in) , std::istreambuf_iterator<char>() };
+      benchmark(file,text,threads,queries,k);
+    }
+
+  return 0;
+}
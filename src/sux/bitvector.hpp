@@ -0,0 +1,400 @@
+/*
+ * bitvector.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef BITVECTOR_HPP_
+#define BITVECTOR_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+#include "../util/parallelization.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * Succinct data structures: Bit vectors with rank and select
+   * support, the building blocks of compressed indexes.
+   */
+  namespace succinct {
+
+    namespace tools {
+
+      /**
+       * The number of set bits of a word. This is a single instruction
+       * if the target supports it (e.g. compiled with -mpopcnt or
+       * -march=native).
+       */
+      inline unsigned popcount(const std::uint64_t word)
+      { return static_cast<unsigned>(__builtin_popcountll(word)); }
+
+      /**
+       * The position of the set bit of `word` that has `rank` set bits
+       * before it. `rank` must be less than `popcount(word)`. With
+       * BMI2, this deposits a single bit at the rank-th set bit of the
+       * word (pdep); otherwise, whole bytes are skipped first.
+       */
+      inline unsigned select_in_word(std::uint64_t word, unsigned rank)
+      {
+#ifdef __BMI2__
+        return static_cast<unsigned>(
+            __builtin_ctzll(_pdep_u64(std::uint64_t(1) << rank,word)));
+#else
+        unsigned offset
+        { 0 };
+        for (unsigned byte_ones = popcount(word & 0xff) ;
+            rank >= byte_ones ; byte_ones = popcount(word & 0xff))
+          {
+            rank   -= byte_ones;
+            word  >>= 8;
+            offset += 8;
+          }
+        for ( ; rank > 0 ; --rank)
+          word &= word - 1;
+        return offset + static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+      }
+
+    }
+
+    /**
+     * A bit vector with rank and select support.
+     *
+     * The rank directory follows Vigna's rank9: For every block of 512
+     * bits (8 words) it stores the number of set bits before the block
+     * and, interleaved with it in the same 16 bytes, the cumulative
+     * counts of the first 7 words of the block as 9-bit fields. A rank
+     * query reads one directory entry and one word, and the directory
+     * adds 25% to the size of the bits.
+     *
+     * Select queries start from a sample of the block of every
+     * `select_sample`-th set (or unset) bit, binary search the blocks
+     * between two samples, and then use the 9-bit counts and
+     * `tools::select_in_word()`.
+     *
+     * After the bits have been set with `set()`, `build_index()` must
+     * be called before any rank or select query.
+     */
+    class bitvector
+    {
+    public:
+      typedef std::uint64_t word_type;
+
+      static constexpr std::size_t word_bits     = 64;
+      static constexpr std::size_t block_words   = 8;
+      static constexpr std::size_t block_bits    = word_bits * block_words;
+      static constexpr std::size_t select_sample = 1024;
+
+      /**
+       * Directory entry of one block: the set bits before the block,
+       * and those before words 1..7 relative to the block.
+       */
+      struct block_counts
+      {
+        word_type _absolute;
+        word_type _relative;
+      };
+
+      bitvector()
+      : _size(0), _ones(0), _words(block_words), _blocks(), _select1(), _select0()
+      { }
+
+      /**
+       * A bit vector of `size` unset bits.
+       */
+      explicit bitvector(const std::size_t size)
+      : _size(size), _ones(0), _words((size / block_bits + 1) * block_words),
+        _blocks(), _select1(), _select0()
+      { }
+
+      /**
+       * A bit vector of `size` bits, where bit i is `bit_at(i)`. The
+       * words and the index are computed by `threads` parallel threads,
+       * so `bit_at` must be safe to call concurrently.
+       */
+      template <typename BitAt>
+      bitvector(const std::size_t size, BitAt bit_at, unsigned threads = 4)
+      : bitvector(size)
+      {
+        using std::distance;
+        typedef std::vector<word_type>::iterator wordit;
+
+        rlxutil::parallel::portions portions
+        { _words.begin() , _words.end() , threads , 1000 };
+        auto futs = portions.apply(_words.begin(),_words.end(),
+            [this,&bit_at](wordit from, wordit to)
+            {
+              std::size_t pos
+              { static_cast<std::size_t>(distance(_words.begin(),from)) * word_bits };
+              for ( ; from != to ; ++from)
+                {
+                  word_type word
+                  { 0 };
+                  for (std::size_t bit = 0 ; bit < word_bits && pos < _size ; ++bit, ++pos)
+                    if (bit_at(pos))
+                      word |= (word_type(1) << bit);
+                  *from = word;
+                }
+            });
+        rlxutil::parallel::tools::wait_for(futs);
+        build_index(threads);
+      }
+
+      std::size_t size() const  { return _size; }
+      /** The number of set bits. Valid after `build_index()`. */
+      std::size_t ones() const  { return _ones; }
+      std::size_t zeros() const { return _size - _ones; }
+
+      bool operator[](const std::size_t pos) const
+      { return ((_words[pos / word_bits] >> (pos % word_bits)) & 1) != 0; }
+
+      void set(const std::size_t pos, const bool value = true)
+      {
+        const word_type mask
+        { word_type(1) << (pos % word_bits) };
+        if (value)
+          _words[pos / word_bits] |= mask;
+        else
+          _words[pos / word_bits] &= ~mask;
+      }
+
+      /**
+       * The number of set bits in [0,pos), for pos <= size().
+       */
+      std::size_t rank1(const std::size_t pos) const
+      {
+        const std::size_t word
+        { pos / word_bits };
+        const block_counts &counts = _blocks[word / block_words];
+        /* For the first word of a block, the shift is 63, which
+         * selects the always unset top bit of the relative counts. */
+        const word_type t
+        { static_cast<word_type>(word % block_words) - 1 };
+        return counts._absolute
+            + ((counts._relative >> ((t + ((t >> 60) & 8)) * 9)) & 0x1ff)
+            + tools::popcount(_words[word] & ((word_type(1) << (pos % word_bits)) - 1));
+      }
+
+      /**
+       * The number of unset bits in [0,pos), for pos <= size().
+       */
+      std::size_t rank0(const std::size_t pos) const
+      { return pos - rank1(pos); }
+
+      /**
+       * The position of the set bit that has `rank` set bits before it,
+       * for rank < ones().
+       */
+      std::size_t select1(const std::size_t rank) const
+      { return select<true>(rank,_select1); }
+
+      /**
+       * The position of the unset bit that has `rank` unset bits before
+       * it, for rank < zeros().
+       */
+      std::size_t select0(const std::size_t rank) const
+      { return select<false>(rank,_select0); }
+
+      /**
+       * Compute the rank directory and the select samples, using
+       * `threads` parallel threads.
+       */
+      void build_index(unsigned threads = 4)
+      {
+        using std::distance;
+        using std::make_tuple;
+        using rlxutil::parallel::tools::wait_for;
+        using rlxutil::parallel::tools::arg_generator;
+        typedef std::vector<block_counts>::iterator blockit;
+
+        /* Bits beyond the end must be unset. */
+        if (_size % word_bits != 0)
+          _words[_size / word_bits] &= (word_type(1) << (_size % word_bits)) - 1;
+
+        _blocks.assign(_words.size() / block_words,block_counts());
+        rlxutil::parallel::portions portions
+        { _blocks.begin() , _blocks.end() , threads , 1000 };
+
+        /* Relative counts, and the total of each block (temporarily in
+         * `_absolute`). */
+        auto count_futs = portions.apply(_blocks.begin(),_blocks.end(),
+            [this](blockit from, blockit to)
+            {
+              auto word = _words.begin() + distance(_blocks.begin(),from) * block_words;
+              std::size_t portion_ones
+              { 0 };
+              for ( ; from != to ; ++from)
+                {
+                  word_type ones
+                  { 0 };
+                  word_type relative
+                  { 0 };
+                  for (std::size_t w = 0 ; w < block_words ; ++w)
+                    {
+                      if (w > 0)
+                        relative |= ones << (9 * (w - 1));
+                      ones += tools::popcount(*word++);
+                    }
+                  from->_absolute = ones;
+                  from->_relative = relative;
+                  portion_ones += ones;
+                }
+              return portion_ones;
+            });
+        std::vector<std::size_t> portion_offsets
+        { };
+        _ones = 0;
+        for (auto &count_fut : count_futs)
+          {
+            portion_offsets.push_back(_ones);
+            _ones += count_fut.get();
+          }
+
+        /* Absolute counts. */
+        auto sum_futs = portions.apply_dynargs(_blocks.begin(),_blocks.end(),
+            [](blockit from, blockit to, std::size_t ones)
+            {
+              for ( ; from != to ; ++from)
+                {
+                  const std::size_t block_ones = from->_absolute;
+                  from->_absolute = ones;
+                  ones += block_ones;
+                }
+            },
+            arg_generator([&portion_offsets](std::size_t portion)
+            { return make_tuple(portion_offsets[portion]); }));
+        wait_for(sum_futs);
+
+        sample<true>(_select1,_ones,portions);
+        sample<false>(_select0,_words.size() * word_bits - _ones,portions);
+      }
+
+      /**
+       * The memory used by the bits, the rank directory and the select
+       * samples, in bytes.
+       */
+      std::size_t size_in_bytes() const
+      {
+        return sizeof(*this)
+            + _words.size() * sizeof(word_type)
+            + _blocks.size() * sizeof(block_counts)
+            + (_select1.size() + _select0.size()) * sizeof(std::size_t);
+      }
+
+    private:
+      /**
+       * The number of bits equal to `Bit` before block `block`, and
+       * before word `w` of the block relative to the block.
+       */
+      template <bool Bit>
+      std::size_t before_block(const std::size_t block) const
+      {
+        const std::size_t ones
+        { static_cast<std::size_t>(_blocks[block]._absolute) };
+        return (Bit ? ones : block * block_bits - ones);
+      }
+
+      template <bool Bit>
+      std::size_t before_word(const std::size_t block, const std::size_t w) const
+      {
+        const std::size_t ones
+        { (w == 0 ? 0 : static_cast<std::size_t>((_blocks[block]._relative >> (9 * (w - 1))) & 0x1ff)) };
+        return (Bit ? ones : w * word_bits - ones);
+      }
+
+      /**
+       * Store the block of every `select_sample`-th bit equal to `Bit`,
+       * followed by the last block. Each portion of blocks writes the
+       * samples that fall into it.
+       */
+      template <bool Bit>
+      void sample(std::vector<std::size_t> &samples, const std::size_t total,
+          const rlxutil::parallel::portions &portions)
+      {
+        using std::distance;
+        typedef std::vector<block_counts>::const_iterator blockit;
+
+        const std::size_t last_block
+        { _blocks.size() - 1 };
+        samples.assign((total + select_sample - 1) / select_sample + 1,last_block);
+        auto futs = portions.apply(_blocks.cbegin(),_blocks.cend(),
+            [this,&samples,last_block](blockit from, blockit to)
+            {
+              std::size_t block
+              { static_cast<std::size_t>(distance(_blocks.cbegin(),from)) };
+              for ( ; from != to ; ++from, ++block)
+                {
+                  const std::size_t begin
+                  { before_block<Bit>(block) };
+                  const std::size_t end
+                  { (block == last_block ? (Bit ? _ones : _words.size() * word_bits - _ones)
+                      : before_block<Bit>(block + 1)) };
+                  for (std::size_t s = (begin + select_sample - 1) / select_sample ;
+                      s * select_sample < end ; ++s)
+                    samples[s] = block;
+                }
+            });
+        rlxutil::parallel::tools::wait_for(futs);
+      }
+
+      template <bool Bit>
+      std::size_t select(const std::size_t rank, const std::vector<std::size_t> &samples) const
+      {
+        /* The last block in the sampled range whose count is <= rank. */
+        std::size_t low
+        { samples[rank / select_sample] };
+        std::size_t high
+        { samples[rank / select_sample + 1] };
+        while (low < high)
+          {
+            const std::size_t mid
+            { low + (high - low + 1) / 2 };
+            if (before_block<Bit>(mid) <= rank)
+              low = mid;
+            else
+              high = mid - 1;
+          }
+        const std::size_t block
+        { low };
+
+        std::size_t remaining
+        { rank - before_block<Bit>(block) };
+        std::size_t w
+        { 1 };
+        while (w < block_words && before_word<Bit>(block,w) <= remaining)
+          ++w;
+        --w;
+        remaining -= before_word<Bit>(block,w);
+
+        const word_type word
+        { _words[block * block_words + w] };
+        return (block * block_words + w) * word_bits
+            + tools::select_in_word(Bit ? word : ~word,static_cast<unsigned>(remaining));
+      }
+
+      std::size_t               _size;
+      std::size_t               _ones;
+      std::vector<word_type>    _words;
+      std::vector<block_counts> _blocks;
+      std::vector<std::size_t>  _select1;
+      std::vector<std::size_t>  _select0;
+    };
+
+  } // succinct
+
+} // rlxalgo
+
+
+#endif /* BITVECTOR_HPP_ */
@@ -0,0 +1,129 @@
+/*
+ * bwt.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef BWT_HPP_
+#define BWT_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../util/more_type_traits.hpp"
+#include "../util/parallelization.hpp"
+#include "suffix_array.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * The Burrows-Wheeler transform (BWT) of a text T of length n: The
+   * character preceding each suffix of T$, in the order of the suffixes,
+   * where $ is a sentinel smaller than all characters. The BWT has n+1
+   * characters; the one preceding the whole text is the sentinel, and
+   * its row is called the primary index.
+   */
+  namespace bwt {
+
+    /**
+     * The BWT is computed in blocks of this many rows, each of them by
+     * parallel threads, and then written to the output iterator.
+     */
+    constexpr std::size_t block_rows = std::size_t(1) << 20;
+
+    /**
+     * Write the BWT of the text [from,to), given its suffix array, to
+     * `out`. The sentinel is written as `sentinel`.
+     * @return The primary index.
+     */
+    template <typename It, typename Pos, typename OutIt,
+              typename Char = typename std::remove_cv<rlxtype::deref<It>>::type>
+    Pos from_suffix_array(
+        It from, It to, const std::vector<Pos> &sux_array, OutIt out,
+        unsigned threads = 4, Char sentinel = Char())
+    {
+      using rlxutil::parallel::tools::wait_for;
+      typedef typename std::vector<Pos>::const_iterator saiter;
+
+      const std::size_t length
+      { sux_array.size() };
+      if (static_cast<std::size_t>(std::distance(from,to)) != length)
+        throw std::invalid_argument("The suffix array passed to the BWT construction "
+            "does not match the length of the text");
+
+      /* Row 0 is the suffix $, preceded by the last character. */
+      if (length == 0)
+        {
+          *out++ = sentinel;
+          return 0;
+        }
+      *out++ = from[length - 1];
+
+      Pos primary
+      { 0 };
+      std::vector<Char> buffer(std::min(block_rows,length));
+      for (std::size_t block = 0 ; block < length ; block += block_rows)
+        {
+          const saiter block_from
+          { sux_array.begin() + block };
+          const saiter block_to
+          { sux_array.begin() + std::min(block + block_rows,length) };
+
+          rlxutil::parallel::portions portions
+          { block_from , block_to , threads };
+          auto futs = portions.apply(block_from,block_to,
+              [from,sentinel,&buffer,block_from](saiter sa_from, saiter sa_to) -> std::ptrdiff_t
+              {
+                std::ptrdiff_t primary_offset
+                { -1 };
+                auto dest = buffer.begin() + std::distance(block_from,sa_from);
+                for (auto sa_it = sa_from ; sa_it != sa_to ; ++sa_it)
+                  if (*sa_it == 0)
+                    {
+                      primary_offset = std::distance(block_from,sa_it);
+                      *dest++ = sentinel;
+                    }
+                  else
+                    *dest++ = from[*sa_it - 1];
+                return primary_offset;
+              });
+          for (auto &fut : futs)
+            {
+              const std::ptrdiff_t primary_offset = fut.get();
+              if (primary_offset >= 0)
+                primary = static_cast<Pos>(block + primary_offset + 1);
+            }
+
+          out = std::copy(buffer.begin(),buffer.begin() + std::distance(block_from,block_to),out);
+        }
+
+      return primary;
+    }
+
+    /**
+     * Compute the BWT of the text [from,to) and write it to `out`, which
+     * may e.g. be a `std::ostreambuf_iterator` of a file. The suffix
+     * array is built with the given engine and released afterwards, so
+     * the BWT is never held in memory together with it.
+     * @return The primary index.
+     */
+    template <typename Pos, SAEngine engine = SAEngine::skew, typename It, typename OutIt,
+              typename Char = typename std::remove_cv<rlxtype::deref<It>>::type>
+    Pos make_bwt(It from, It to, OutIt out, unsigned threads = 4, Char sentinel = Char())
+    {
+      const std::vector<Pos> sux_array
+      { make_suffix_array<Pos,engine>(from,to,threads) };
+      return from_suffix_array(from,to,sux_array,out,threads,sentinel);
+    }
+
+  } // bwt
+
+} // rlxalgo
+
+
+#endif /* BWT_HPP_ */
@@ -0,0 +1,374 @@
+/*
+ * dcx.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef DCX_HPP_
+#define DCX_HPP_
+
+#include <limits>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "../util/more_algorithm.hpp"
+#include "../util/parallelization.hpp"
+#include "alphabet.hpp"
+#include "trigram.hpp"
+#include "qgram.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * Suffix array construction using the difference cover algorithm DCX
+   * (Kärkkäinen, Sanders and Burkhardt 2006), for any difference cover
+   * chosen at compile time. `skew.hpp` is the specialised
+   * implementation for DC3, based on trigrams.
+   */
+  namespace dcx {
+
+    template <typename... Ts> using sequence = std::vector<Ts...>;
+
+    /**
+     * A difference cover modulo `V` is a set D of residues such that
+     * every residue in [0,V) is the difference (modulo V) of two members
+     * of D. The suffixes starting at positions i with (i mod V) in D are
+     * sorted first, by recursion on their V-grams. For any two positions
+     * i and j there is an l < V such that i+l and j+l are both sample
+     * positions, so comparing any two suffixes takes at most l character
+     * comparisons and one rank comparison.
+     *
+     * The sample is a fraction |D|/V of the text: 2/3 for DC3, 3/7 for
+     * DC7 and 4/13 for DC13. Larger covers make the recursion shrink
+     * faster, but each sample suffix is sorted by V characters.
+     */
+    template <unsigned V>
+    struct difference_cover;
+
+    template <>
+    struct difference_cover<3>
+    {
+      static constexpr unsigned period = 3;
+      static constexpr unsigned size   = 2;
+      static constexpr unsigned member(unsigned k)
+      { return (k == 0 ? 1 : 2); }
+    };
+
+    template <>
+    struct difference_cover<7>
+    {
+      static constexpr unsigned period = 7;
+      static constexpr unsigned size   = 3;
+      static constexpr unsigned member(unsigned k)
+      { return (k == 0 ? 1 : k == 1 ? 2 : 4); }
+    };
+
+    template <>
+    struct difference_cover<13>
+    {
+      static constexpr unsigned period = 13;
+      static constexpr unsigned size   = 4;
+      static constexpr unsigned member(unsigned k)
+      { return (k == 0 ? 1 : k == 1 ? 2 : k == 2 ? 4 : 10); }
+    };
+
+    typedef difference_cover<3>  dc3;
+    typedef difference_cover<7>  dc7;
+    typedef difference_cover<13> dc13;
+
+    /**
+     * Lookup tables derived from a difference cover.
+     */
+    template <typename Cover>
+    struct cover_table
+    {
+      static constexpr unsigned V = Cover::period;
+
+      /** Index of each residue in the cover, or -1 if it is not a member. */
+      std::array<int,V> _index;
+      /** For each pair of residues (r1,r2), the smallest l such that both
+       * r1+l and r2+l are members (modulo V). */
+      std::array<std::array<unsigned,V>,V> _delta;
+
+      cover_table()
+      {
+        _index.fill(-1);
+        for (unsigned k = 0 ; k < Cover::size ; ++k)
+          _index[Cover::member(k)] = static_cast<int>(k);
+        for (unsigned r1 = 0 ; r1 < V ; ++r1)
+          for (unsigned r2 = 0 ; r2 < V ; ++r2)
+            {
+              unsigned l = 0;
+              while (!is_member((r1 + l) % V) || !is_member((r2 + l) % V))
+                ++l;
+              _delta[r1][r2] = l;
+            }
+      }
+
+      bool is_member(unsigned residue) const
+      { return (_index[residue] >= 0); }
+    };
+
+    /**
+     * Compute the suffix array of the first `length` characters of `text`,
+     * using the difference cover `Cover`. The characters must be in
+     * [1,highest], and `text` must be followed by at least `V`
+     * 0-characters that serve as sentinels.
+     */
+    template <typename Pos, typename Cover, typename Char>
+    sequence<Pos> make_padded_suffix_array(
+        const sequence<Char> &text, std::size_t length, std::size_t highest, unsigned threads)
+    {
+      using std::size_t;
+      using std::make_tuple;
+      using rlx::AlphabetClass;
+      using rlx::Alphabet;
+      using rlxutil::parallel::tools::wait_for;
+      using rlxutil::parallel::tools::arg_generator;
+
+      typedef typename sequence<Pos>::iterator posit;
+      typedef sux::TrigramSorter<Char,Pos>      sorter;
+
+      constexpr unsigned V = Cover::period;
+      static const cover_table<Cover> table
+      { };
+
+      if (length == 0)
+        return { };
+
+      const Alphabet<AlphabetClass::zero_range,Char,Pos> alphabet
+      { highest + 1 };
+
+      /* The sample consists of all positions i <= length with (i mod V)
+       * in the cover. Including positions up to `length` ensures that the
+       * last V-gram of each residue class contains a sentinel, so its name
+       * is unique and suffixes of the reduced string never compare across
+       * the boundary between two classes. In the reduced string, the
+       * classes are stored one after the other. */
+      std::array<size_t,Cover::size + 1> offsets;
+      offsets[0] = 0;
+      for (unsigned k = 0 ; k < Cover::size ; ++k)
+        {
+          const size_t residue = Cover::member(k);
+          offsets[k+1] = offsets[k] + (residue <= length ? (length - residue) / V + 1 : 0);
+        }
+      const size_t num_sample
+      { offsets[Cover::size] };
+
+      auto reduced_index = [&offsets](size_t pos) -> size_t
+      { return offsets[table._index[pos % V]] + pos / V; };
+      auto position_of = [&offsets](size_t index) -> Pos
+      {
+        unsigned k = 0;
+        while (index >= offsets[k+1])
+          ++k;
+        return static_cast<Pos>(Cover::member(k) + V * (index - offsets[k]));
+      };
+
+      sequence<Pos> sample(num_sample);
+      rlxutil::parallel::portions portions
+      { sample.begin() , sample.end() , threads };
+      auto make_futs = portions.apply(sample.begin(),sample.end(),
+          [&position_of](posit from, posit to, posit beg)
+          {
+            size_t index = std::distance(beg,from);
+            while (from != to)
+              *from++ = position_of(index++);
+          },sample.begin());
+      wait_for(make_futs);
+
+      /* Sort the sample positions by their V-grams. */
+      sux::QGramSorter<V,Char,Pos>::sort_positions(sample,text,alphabet,threads);
+
+      /* Name the V-grams. Names start at 1, and they are stored in
+       * reduced-string order. */
+      auto qgram_differs = [&text](Pos pos1, Pos pos2)
+      {
+        for (unsigned k = 0 ; k < V ; ++k)
+          if (text[pos1 + k] != text[pos2 + k])
+            return true;
+        return false;
+      };
+
+      sequence<Pos> ranks(num_sample + V,0);
+      auto count_futs = portions.apply(sample.begin(),sample.end(),
+          [&qgram_differs](posit from, posit to, posit beg)
+          {
+            Pos count = 0;
+            for ( ; from != to ; ++from)
+              if (from == beg || qgram_differs(*std::prev(from),*from))
+                ++count;
+            return count;
+          },sample.begin());
+      std::vector<Pos> first_names
+      { };
+      Pos num_names
+      { 0 };
+      for (auto &count_fut : count_futs)
+        {
+          first_names.push_back(num_names);
+          num_names += count_fut.get();
+        }
+      auto name_futs = portions.apply_dynargs(sample.begin(),sample.end(),
+          [&qgram_differs,&reduced_index,&ranks](posit from, posit to, posit beg, Pos name)
+          {
+            for ( ; from != to ; ++from)
+              {
+                if (from == beg || qgram_differs(*std::prev(from),*from))
+                  ++name;
+                ranks[reduced_index(*from)] = name;
+              }
+          },
+          arg_generator([&sample,&first_names](size_t portion)
+          { return make_tuple(sample.begin(),first_names[portion]); }));
+      wait_for(name_futs);
+
+      /* If the names are not unique, sort the reduced string by
+       * recursion. Afterwards, `sample` is sorted and `ranks` holds the
+       * rank of each sample suffix, in reduced-string order. */
+      if (num_names < num_sample)
+        {
+          sequence<Pos> rec_sa =
+              make_padded_suffix_array<Pos,Cover>(ranks,num_sample,num_names,threads);
+          auto futs = portions.apply(rec_sa.begin(),rec_sa.end(),
+              [&ranks,&sample,&position_of](posit from, posit to, posit beg)
+              {
+                Pos rank = static_cast<Pos>(std::distance(beg,from));
+                while (from != to)
+                  {
+                    const Pos index = *from++;
+                    ranks[index]  = ++rank;
+                    sample[rank - 1] = position_of(index);
+                  }
+              },rec_sa.begin());
+          wait_for(futs);
+        }
+
+      /* Rank of the suffix at a sample position. The empty suffix (and
+       * anything beyond) is ranked 0. */
+      auto rank_of = [length,&ranks,&reduced_index](size_t pos) -> Pos
+      { return (pos >= length ? 0 : ranks[reduced_index(pos)]); };
+
+      /* Sorted lists of suffixes, one for all sample positions, and one
+       * for each other residue class. */
+      std::vector<sequence<Pos>> lists
+      { };
+      lists.emplace_back();
+      std::copy_if(sample.begin(),sample.end(),std::back_inserter(lists.back()),
+          [length](Pos pos) { return pos < length; });
+
+      /* A non-sample position i is followed by a sample position i+l at
+       * distance l = delta(i,i). Scanning the sorted sample yields the
+       * positions of each class ordered by rank(i+l), and l stable passes
+       * on the characters complete the order. The position of a class
+       * whose i+l is beyond the text has rank 0 and comes first. */
+      std::array<std::vector<std::pair<size_t,size_t>>,V> successors;
+      for (unsigned residue = 0 ; residue < V ; ++residue)
+        if (!table.is_member(residue))
+          {
+            const size_t dist = table._delta[residue][residue];
+            successors[(residue + dist) % V].emplace_back(lists.size(),dist);
+            lists.emplace_back();
+            for (size_t pos = (length > dist ? length - dist : 0) ; pos < length ; ++pos)
+              if (pos % V == residue)
+                lists.back().push_back(static_cast<Pos>(pos));
+          }
+      for (const Pos pos : lists.front())
+        for (const auto &succ : successors[pos % V])
+          if (pos >= succ.second)
+            lists[succ.first].push_back(static_cast<Pos>(pos - succ.second));
+      sample = sequence<Pos>();
+
+      for (unsigned residue = 0, list = 1 ; residue < V ; ++residue)
+        if (!table.is_member(residue))
+          {
+            sequence<Pos> &class_list = lists[list++];
+            sequence<Pos> temp(class_list.size());
+            rlxutil::parallel::portions class_portions
+            { class_list.begin() , class_list.end() , threads };
+            for (unsigned k = table._delta[residue][residue] ; k-- > 0 ; )
+              sorter::lsd_pass(class_list,temp,
+                  [&text,k](const Pos &pos) { return text[pos + k]; },alphabet,class_portions);
+          }
+
+      /* Merge the lists pairwise. Two suffixes are compared by their
+       * first l characters, where l = delta(lhs,rhs), and then by the
+       * ranks of the sample suffixes at distance l. */
+      auto compare = [&text,&rank_of](const Pos &lhs, const Pos &rhs)
+      {
+        const unsigned dist = table._delta[lhs % V][rhs % V];
+        for (unsigned k = 0 ; k < dist ; ++k)
+          if (text[lhs + k] != text[rhs + k])
+            return (text[lhs + k] < text[rhs + k]);
+        return (rank_of(lhs + dist) < rank_of(rhs + dist));
+      };
+
+      while (lists.size() > 1)
+        {
+          std::vector<sequence<Pos>> merged
+          { };
+          for (size_t i = 0 ; i + 1 < lists.size() ; i += 2)
+            {
+              merged.emplace_back(lists[i].size() + lists[i+1].size());
+              rlx::paralgo::merge_sorted(
+                  lists[i].begin(),lists[i].end(),lists[i+1].begin(),lists[i+1].end(),
+                  merged.back().begin(),compare,threads);
+              lists[i]   = sequence<Pos>();
+              lists[i+1] = sequence<Pos>();
+            }
+          if (lists.size() % 2 == 1)
+            merged.push_back(std::move(lists.back()));
+          lists = std::move(merged);
+        }
+
+      return std::move(lists.front());
+    }
+
+    /**
+     * Calls `make_padded_suffix_array()` for texts of any character
+     * type (see `rlx::alphabet_tools::with_sentinel_text()`).
+     */
+    template <typename Pos, typename Cover>
+    struct padded_builder
+    {
+      unsigned _threads;
+
+      template <typename Char>
+      sequence<Pos> operator()(const sequence<Char> &text, std::size_t length, std::size_t highest) const
+      { return make_padded_suffix_array<Pos,Cover>(text,length,highest,_threads); }
+    };
+
+    /**
+     * Compute the suffix array of the text [from,to) using the difference
+     * cover `Cover` (e.g. `dcx::dc7`), with `threads` parallel threads.
+     */
+    template <typename Pos, typename Cover = dc7, typename It>
+    sequence<Pos> make_suffix_array(It from, It to, unsigned threads = 4)
+    {
+      using std::numeric_limits;
+      using std::uintmax_t;
+
+      static_assert(std::is_integral<Pos>::value,
+          "The position type used for make_suffix_array must be an integral type.");
+      if (static_cast<uintmax_t>(numeric_limits<Pos>::max())
+          < static_cast<uintmax_t>(std::distance(from,to)) + Cover::period)
+        throw std::out_of_range("Attempt to use a position type with make_suffix_array that "
+            "is not large enough for the given input string");
+
+      return rlx::alphabet_tools::with_sentinel_text<Pos>(from,to,Cover::period,threads,
+          padded_builder<Pos,Cover>
+          { threads });
+    }
+
+  } // dcx
+
+} // rlxalgo
+
+
+#endif /* DCX_HPP_ */
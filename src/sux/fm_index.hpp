@@ -0,0 +1,401 @@
+/*
+ * fm_index.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef FM_INDEX_HPP_
+#define FM_INDEX_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../util/more_type_traits.hpp"
+#include "../util/parallelization.hpp"
+#include "alphabet.hpp"
+#include "suffix_array.hpp"
+#include "bwt.hpp"
+#include "search.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * The FM-index of Ferragina and Manzini (2000): The BWT of a text,
+   * the C array (for each character, the number of characters of the
+   * text smaller than it) and a rank directory that counts the
+   * occurrences of each character in every prefix of the BWT. Patterns
+   * are searched backwards, one rank operation pair per character, and
+   * neither the text nor its suffix array are needed at query time.
+   */
+  namespace fm {
+
+    /**
+     * FM-index of a text over characters of type `Char`. The characters
+     * are mapped to their ranks 0..sigma-1 among the characters that
+     * occur, using a frequency table of a sparse `rlx::Alphabet`, and
+     * the BWT is stored as a sequence of ranks (symbols).
+     *
+     * The rank directory stores, for every symbol, the number of its
+     * occurrences before each superblock of `super_size` rows (as
+     * `Pos`) and before each block of `block_size` rows relative to the
+     * superblock (as 16-bit counts). A rank query reads one superblock
+     * and one block counter and scans at most half a block, forwards
+     * from the block start or backwards from the next one. The
+     * directory takes sigma/128 bytes per character.
+     *
+     * The sentinel row of the BWT (the primary index) holds symbol 0 as
+     * a placeholder, which `occ()` subtracts.
+     */
+    template <typename Char, typename Pos>
+    class fm_index
+    {
+    public:
+      typedef Char                                                   char_type;
+      typedef Pos                                                    pos_type;
+      typedef rlx::alphabet_tools::compact_char_type<Char,Pos>       symbol_type;
+      typedef search::sa_interval<Pos>                               interval_type;
+      typedef rlx::Alphabet<rlx::AlphabetClass::sparse,Char,Pos>     alphabet_type;
+      typedef typename alphabet_type::freq_table_type                rank_table_type;
+
+      /** Rows per block and per superblock of the rank directory. */
+      static constexpr std::size_t block_size = 256;
+      static constexpr std::size_t super_size = std::size_t(1) << 16;
+
+      fm_index()
+      : _length(0), _sigma(0), _primary(0), _ranks(), _c(), _bwt(), _supers(), _blocks()
+      { }
+
+      /**
+       * Build the FM-index of the text [from,to). The suffix array is
+       * built with the default engine and released when the BWT has
+       * been derived from it.
+       */
+      template <typename It>
+      fm_index(It from, It to, unsigned threads = 4)
+      : fm_index(from,to,make_suffix_array<Pos>(from,to,threads),threads)
+      { }
+
+      /**
+       * Build the FM-index of the text [from,to), given its suffix
+       * array. Character counting, the BWT and the rank directory are
+       * computed by `threads` parallel threads.
+       */
+      template <typename It>
+      fm_index(It from, It to, const std::vector<Pos> &sux_array, unsigned threads = 4)
+      : fm_index()
+      { build(from,to,sux_array,threads); }
+
+      /** The length of the text. */
+      Pos size() const        { return _length; }
+      /** The number of distinct characters of the text. */
+      std::size_t sigma() const { return _sigma; }
+      /** The BWT row that holds the sentinel. */
+      Pos primary() const     { return _primary; }
+
+      /**
+       * Map a character to its symbol.
+       * @return false if the character does not occur in the text.
+       */
+      bool symbol_of(const Char c, symbol_type &symbol) const
+      { return lookup(c,symbol,typename alphabet_type::is_dense()); }
+
+      /**
+       * The number of occurrences of `symbol` in the BWT rows [0,row).
+       */
+      Pos occ(const symbol_type symbol, const Pos row) const
+      {
+        const std::size_t block
+        { row / block_size };
+        const std::size_t offset
+        { row % block_size };
+        const std::size_t next
+        { (block + 1) * block_size };
+        const symbol_type *bwt
+        { _bwt.data() };
+
+        Pos result;
+        if (offset > block_size / 2 && next <= _bwt.size())
+          result = rank_at(block + 1,symbol) - count_in(bwt + row,bwt + next,symbol);
+        else
+          result = rank_at(block,symbol) + count_in(bwt + (row - offset),bwt + row,symbol);
+        if (symbol == 0 && _primary < row)
+          --result;
+        return result;
+      }
+
+      /**
+       * The LF mapping: the row of the suffix that starts one position
+       * before the suffix of `row` (cyclically, so the whole text maps
+       * to the sentinel row 0).
+       */
+      Pos lf(const Pos row) const
+      {
+        if (row == _primary)
+          return 0;
+        const symbol_type symbol
+        { _bwt[row] };
+        return _c[symbol] + occ(symbol,row);
+      }
+
+      /**
+       * Find the pattern [from,to) by backward search.
+       * @return The interval of the suffix array of the text that holds
+       *   the suffixes beginning with the pattern.
+       */
+      template <typename PatIt>
+      interval_type find(PatIt from, PatIt to) const
+      {
+        Pos first
+        { 0 };
+        Pos last
+        { static_cast<Pos>(_bwt.size()) };
+        while (to != from)
+          {
+            symbol_type symbol;
+            if (!symbol_of(*--to,symbol))
+              return { 0 , 0 };
+            first = _c[symbol] + occ(symbol,first);
+            last  = _c[symbol] + occ(symbol,last);
+            if (first >= last)
+              return { 0 , 0 };
+          }
+        /* Row r is the suffix at position r-1 of the suffix array; row
+         * 0 (the sentinel) only matches the empty pattern. */
+        return { static_cast<Pos>(first > 0 ? first - 1 : 0) , static_cast<Pos>(last - 1) };
+      }
+
+      template <typename Pattern>
+      interval_type find(const Pattern &pattern) const
+      { return find(std::begin(pattern),std::end(pattern)); }
+
+      /**
+       * The number of occurrences of the pattern [from,to).
+       */
+      template <typename PatIt>
+      Pos count(PatIt from, PatIt to) const
+      { return find(from,to).size(); }
+
+      template <typename Pattern>
+      Pos count(const Pattern &pattern) const
+      { return find(pattern).size(); }
+
+      /**
+       * The memory used by the index, in bytes.
+       */
+      std::size_t size_in_bytes() const
+      {
+        return sizeof(*this)
+            + _c.size() * sizeof(Pos)
+            + _bwt.size() * sizeof(symbol_type)
+            + _supers.size() * sizeof(Pos)
+            + _blocks.size() * sizeof(std::uint16_t);
+      }
+
+    private:
+      template <typename It>
+      void build(It from, It to, const std::vector<Pos> &sux_array, unsigned threads)
+      {
+        using std::distance;
+        using rlxutil::parallel::tools::wait_for;
+        using rlx::alphabet_tools::make_freq_table;
+
+        const std::size_t length
+        { static_cast<std::size_t>(distance(from,to)) };
+        if (length != sux_array.size())
+          throw std::invalid_argument("The suffix array passed to the FM-index construction "
+              "does not match the length of the text");
+        if (length >= static_cast<std::size_t>(std::numeric_limits<Pos>::max()))
+          throw std::out_of_range("Attempt to build an FM-index of a text that is "
+              "too long for the position type");
+
+        _length = static_cast<Pos>(length);
+        _c.assign(1,Pos(1));
+        if (length == 0)
+          {
+            _bwt.assign(1,symbol_type());
+            return;
+          }
+
+        const alphabet_type alphabet
+        { };
+        auto char_id = [](const Char c) { return c; };
+        rlxutil::parallel::portions portions
+        { from , to , threads };
+
+        /* Count characters, assign symbols in character order and set
+         * up the C array. The rank table holds symbol+1, so that 0
+         * marks characters that do not occur. */
+        auto count_futs = portions.apply(from,to,
+            make_freq_table<It,decltype(char_id),alphabet_type>,char_id,alphabet);
+        auto counts = alphabet.new_freq_table();
+        for (auto &count_fut : count_futs)
+          alphabet_type::add_char_freq_table(counts,count_fut.get(),portions.threads());
+
+        _ranks = alphabet.new_freq_table();
+        Pos total
+        { 1 };
+        alphabet_type::for_each_char(counts,[this,&total](const Char c, const Pos freq)
+        {
+          _ranks[c] = static_cast<Pos>(++_sigma);
+          total += freq;
+          _c.push_back(total);
+        });
+
+        /* The BWT of the text of symbols. */
+        {
+          std::vector<symbol_type> symbols(length);
+          const rank_table_type &ranks = _ranks;
+          auto rewrite_futs = portions.apply(from,to,
+              [from,&symbols,&ranks](It local_from, It local_to)
+              {
+                auto dest = symbols.begin() + distance(from,local_from);
+                while (local_from != local_to)
+                  *dest++ = static_cast<symbol_type>(ranks.at(*local_from++) - 1);
+              });
+          wait_for(rewrite_futs);
+
+          _bwt.reserve(length + 1);
+          _primary = bwt::from_suffix_array(symbols.begin(),symbols.end(),sux_array,
+              std::back_inserter(_bwt),threads,symbol_type());
+        }
+
+        build_directory(threads);
+      }
+
+      /**
+       * Fill the rank directory. Portions are aligned to superblocks;
+       * each one stores the block counters and the total counts of its
+       * superblocks, which are then added up sequentially.
+       */
+      void build_directory(unsigned threads)
+      {
+        using std::distance;
+        using rlxutil::parallel::tools::wait_for;
+
+        typedef rlxutil::parallel::portions::adjustment adjustment;
+        typedef typename std::vector<symbol_type>::const_iterator symbol_it;
+
+        const std::size_t rows
+        { _bwt.size() };
+        _supers.assign(((rows - 1) / super_size + 2) * _sigma,Pos(0));
+        _blocks.assign((rows / block_size + 1) * _sigma,std::uint16_t(0));
+
+        const symbol_it bwt_begin
+        { _bwt.cbegin() };
+        rlxutil::parallel::portions portions
+        { bwt_begin , _bwt.cend() , threads ,
+          [](symbol_it beg, symbol_it loc, symbol_it /*end*/)
+          { return ((distance(beg,loc) + 1) % super_size != 0 ? adjustment::needed : adjustment::unneeded); }
+        };
+
+        auto futs = portions.apply(bwt_begin,_bwt.cend(),
+            [this,bwt_begin](symbol_it local_from, symbol_it local_to)
+            {
+              std::vector<Pos> counts(_sigma);
+              std::size_t row
+              { static_cast<std::size_t>(distance(bwt_begin,local_from)) };
+              const std::size_t end
+              { static_cast<std::size_t>(distance(bwt_begin,local_to)) };
+              while (row < end)
+                {
+                  const std::size_t super_end
+                  { std::min(row + super_size,end) };
+                  std::fill(counts.begin(),counts.end(),Pos(0));
+                  for ( ; row < super_end ; ++row)
+                    {
+                      if (row % block_size == 0)
+                        store_block(row / block_size,counts);
+                      ++counts[_bwt[row]];
+                    }
+                  if (row % block_size == 0 && row % super_size != 0)
+                    store_block(row / block_size,counts);
+                  std::copy(counts.begin(),counts.end(),
+                      _supers.begin() + ((row - 1) / super_size + 1) * _sigma);
+                }
+            });
+        wait_for(futs);
+
+        for (auto it = _supers.begin() + _sigma ; it != _supers.end() ; ++it)
+          *it += *(it - _sigma);
+      }
+
+      void store_block(const std::size_t block, const std::vector<Pos> &counts)
+      {
+        std::transform(counts.begin(),counts.end(),_blocks.begin() + block * _sigma,
+            [](const Pos count) { return static_cast<std::uint16_t>(count); });
+      }
+
+      /**
+       * The number of occurrences of `symbol` before block `block`.
+       */
+      Pos rank_at(const std::size_t block, const symbol_type symbol) const
+      {
+        return _supers[(block * block_size / super_size) * _sigma + symbol]
+            + _blocks[block * _sigma + symbol];
+      }
+
+      /**
+       * The number of occurrences of `symbol` in [from,to), which is at
+       * most half a block. The loop is simple enough to be vectorised.
+       */
+      static Pos count_in(const symbol_type *from, const symbol_type *to, const symbol_type symbol)
+      {
+        unsigned result
+        { 0 };
+        for ( ; from != to ; ++from)
+          result += (*from == symbol);
+        return static_cast<Pos>(result);
+      }
+
+      bool lookup(const Char c, symbol_type &symbol, std::true_type) const
+      {
+        const Pos rank
+        { _ranks.at(c) };
+        symbol = static_cast<symbol_type>(rank - 1);
+        return (rank != 0);
+      }
+
+      bool lookup(const Char c, symbol_type &symbol, std::false_type) const
+      {
+        auto entry = _ranks.find(c);
+        if (entry == _ranks.end())
+          return false;
+        symbol = static_cast<symbol_type>(entry->second - 1);
+        return true;
+      }
+
+      Pos                        _length;
+      std::size_t                _sigma;
+      Pos                        _primary;
+      rank_table_type            _ranks;
+      std::vector<Pos>           _c;
+      std::vector<symbol_type>   _bwt;
+      std::vector<Pos>           _supers;
+      std::vector<std::uint16_t> _blocks;
+    };
+
+    /**
+     * Build the FM-index of the text [from,to), using the given suffix
+     * array construction engine.
+     */
+    template <typename Pos, SAEngine engine = SAEngine::skew, typename It>
+    fm_index<typename std::remove_cv<rlxtype::deref<It>>::type,Pos>
+    make_fm_index(It from, It to, unsigned threads = 4)
+    {
+      return { from , to ,
+        make_suffix_array<Pos,engine>(from,to,threads) , threads };
+    }
+
+  } // fm
+
+} // rlxalgo
+
+
+#endif /* FM_INDEX_HPP_ */
@@ -0,0 +1,243 @@
+/*
+ * lcp.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef LCP_HPP_
+#define LCP_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../util/parallelization.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * Construction of the longest-common-prefix (LCP) array from a text
+   * and its suffix array, as produced by `skew::make_suffix_array()` or
+   * any of the other engines. `lcp[i]` is the length of the longest
+   * common prefix of the suffixes at `sux_array[i-1]` and `sux_array[i]`,
+   * and `lcp[0]` is 0.
+   *
+   * Both algorithms compute the permuted LCP array (PLCP), i.e. the LCP
+   * values in text order, using the fact that PLCP[p+1] >= PLCP[p]-1
+   * (Kärkkäinen, Manzini and Puglisi 2009). The text is cut into
+   * portions that are processed in parallel; each portion starts
+   * without a known lower bound, which costs at most one extra
+   * comparison of a long common prefix per portion.
+   */
+  namespace lcp {
+
+    template <typename... Ts> using sequence = std::vector<Ts...>;
+
+    namespace tools {
+
+      /**
+       * The length of the common prefix of the suffixes at `pos1` and
+       * `pos2` of the text `text` of length `length`, given that the
+       * first `known` characters are known to be equal.
+       */
+      template <typename It, typename Pos>
+      Pos extend_match(It text, std::size_t length, Pos pos1, Pos pos2, Pos known)
+      {
+        const std::size_t limit
+        { length - (pos1 > pos2 ? pos1 : pos2) };
+        std::size_t matched
+        { known };
+        while (matched < limit && text[pos1 + matched] == text[pos2 + matched])
+          ++matched;
+        return static_cast<Pos>(matched);
+      }
+
+      template <typename It, typename Pos>
+      void check_input(It from, It to, const sequence<Pos> &sux_array)
+      {
+        if (static_cast<std::size_t>(std::distance(from,to)) != sux_array.size())
+          throw std::invalid_argument("The suffix array passed to the LCP construction "
+              "does not match the length of the text");
+      }
+
+    }
+
+    /**
+     * Compute the LCP array of the text [from,to) using the full Φ
+     * array: Φ(p) is the suffix that precedes p in the suffix array.
+     * The PLCP values overwrite Φ in place, so the working memory is
+     * one position per character, in addition to the result. All
+     * three passes (Φ, PLCP, LCP) run in parallel.
+     */
+    template <typename Pos, typename It>
+    sequence<Pos> make_lcp_array_phi(
+        It from, It to, const sequence<Pos> &sux_array, unsigned threads = 4)
+    {
+      using rlxutil::parallel::tools::wait_for;
+
+      typedef typename sequence<Pos>::const_iterator saiter;
+      typedef typename sequence<Pos>::iterator       posit;
+
+      tools::check_input(from,to,sux_array);
+      const std::size_t length
+      { sux_array.size() };
+      if (length == 0)
+        return { };
+      /* Marks the suffix that has no predecessor. */
+      const Pos none
+      { static_cast<Pos>(length) };
+
+      rlxutil::parallel::portions sa_portions
+      { sux_array.begin() , sux_array.end() , threads };
+
+      sequence<Pos> plcp(length);
+      auto phi_futs = sa_portions.apply(sux_array.begin(),sux_array.end(),
+          [&plcp,none](saiter sa_from, saiter sa_to, saiter sa_beg)
+          {
+            for ( ; sa_from != sa_to ; ++sa_from)
+              plcp[*sa_from] = (sa_from == sa_beg ? none : *std::prev(sa_from));
+          },sux_array.begin());
+      wait_for(phi_futs);
+
+      rlxutil::parallel::portions text_portions
+      { plcp.begin() , plcp.end() , threads };
+      auto plcp_futs = text_portions.apply(plcp.begin(),plcp.end(),
+          [from,length,none](posit plcp_from, posit plcp_to, posit plcp_beg)
+          {
+            Pos pos
+            { static_cast<Pos>(std::distance(plcp_beg,plcp_from)) };
+            Pos known
+            { 0 };
+            for ( ; plcp_from != plcp_to ; ++plcp_from, ++pos)
+              {
+                const Pos prev = *plcp_from;
+                known = (prev == none ? 0 : tools::extend_match(from,length,pos,prev,known));
+                *plcp_from = known;
+                if (known > 0)
+                  --known;
+              }
+          },plcp.begin());
+      wait_for(plcp_futs);
+
+      sequence<Pos> result(length);
+      auto lcp_futs = sa_portions.apply(sux_array.begin(),sux_array.end(),
+          [&plcp,&result](saiter sa_from, saiter sa_to, saiter sa_beg)
+          {
+            auto out = result.begin() + std::distance(sa_beg,sa_from);
+            for ( ; sa_from != sa_to ; ++sa_from)
+              *out++ = plcp[*sa_from];
+          },sux_array.begin());
+      wait_for(lcp_futs);
+
+      return result;
+    }
+
+    /**
+     * Compute the LCP array of the text [from,to) using a sparse PLCP
+     * array that holds the values of every `sparseness`-th text position
+     * only. The working memory is one position per `sparseness`
+     * characters, in addition to the result. The LCP value of a suffix
+     * at p = k*sparseness + r is at least PLCP[k*sparseness] - r, and
+     * it is computed by extending that lower bound. This takes
+     * O(n*sparseness) character comparisons in the worst case.
+     */
+    template <typename Pos, typename It>
+    sequence<Pos> make_lcp_array_sparse(
+        It from, It to, const sequence<Pos> &sux_array,
+        unsigned threads = 4, unsigned sparseness = 32)
+    {
+      using rlxutil::parallel::tools::wait_for;
+
+      typedef typename sequence<Pos>::const_iterator saiter;
+      typedef typename sequence<Pos>::iterator       posit;
+
+      tools::check_input(from,to,sux_array);
+      if (sparseness == 0)
+        throw std::invalid_argument("The sparseness of the PLCP array must be positive");
+      const std::size_t length
+      { sux_array.size() };
+      if (length == 0)
+        return { };
+      const Pos none
+      { static_cast<Pos>(length) };
+      const Pos step
+      { static_cast<Pos>(sparseness) };
+
+      rlxutil::parallel::portions sa_portions
+      { sux_array.begin() , sux_array.end() , threads };
+
+      /* Sparse Φ, for positions divisible by the step. */
+      sequence<Pos> sparse_plcp((length + step - 1) / step);
+      auto phi_futs = sa_portions.apply(sux_array.begin(),sux_array.end(),
+          [&sparse_plcp,none,step](saiter sa_from, saiter sa_to, saiter sa_beg)
+          {
+            for ( ; sa_from != sa_to ; ++sa_from)
+              if (*sa_from % step == 0)
+                sparse_plcp[*sa_from / step] = (sa_from == sa_beg ? none : *std::prev(sa_from));
+          },sux_array.begin());
+      wait_for(phi_futs);
+
+      /* Sparse PLCP: PLCP[p+step] >= PLCP[p]-step. */
+      rlxutil::parallel::portions sparse_portions
+      { sparse_plcp.begin() , sparse_plcp.end() , threads , 1000 };
+      auto plcp_futs = sparse_portions.apply(sparse_plcp.begin(),sparse_plcp.end(),
+          [from,length,none,step](posit plcp_from, posit plcp_to, posit plcp_beg)
+          {
+            Pos pos
+            { static_cast<Pos>(std::distance(plcp_beg,plcp_from) * step) };
+            Pos known
+            { 0 };
+            for ( ; plcp_from != plcp_to ; ++plcp_from, pos += step)
+              {
+                const Pos prev = *plcp_from;
+                known = (prev == none ? 0 : tools::extend_match(from,length,pos,prev,known));
+                *plcp_from = known;
+                known = (known > step ? known - step : 0);
+              }
+          },sparse_plcp.begin());
+      wait_for(plcp_futs);
+
+      /* LCP, in suffix array order. */
+      sequence<Pos> result(length);
+      auto lcp_futs = sa_portions.apply(sux_array.begin(),sux_array.end(),
+          [from,length,step,&sparse_plcp,&result](saiter sa_from, saiter sa_to, saiter sa_beg)
+          {
+            auto out = result.begin() + std::distance(sa_beg,sa_from);
+            for ( ; sa_from != sa_to ; ++sa_from)
+              {
+                if (sa_from == sa_beg)
+                  {
+                    *out++ = 0;
+                    continue;
+                  }
+                const Pos pos    = *sa_from;
+                const Pos offset = pos % step;
+                const Pos sample = sparse_plcp[pos / step];
+                *out++ = tools::extend_match(from,length,pos,*std::prev(sa_from),
+                    static_cast<Pos>(sample > offset ? sample - offset : 0));
+              }
+          },sux_array.begin());
+      wait_for(lcp_futs);
+
+      return result;
+    }
+
+    /**
+     * Compute the LCP array of the text [from,to), given its suffix
+     * array. This uses the full Φ array; see `make_lcp_array_sparse()`
+     * for the variant with less working memory.
+     */
+    template <typename Pos, typename It>
+    sequence<Pos> make_lcp_array(
+        It from, It to, const sequence<Pos> &sux_array, unsigned threads = 4)
+    { return make_lcp_array_phi(from,to,sux_array,threads); }
+
+  } // lcp
+
+} // rlxalgo
+
+
+#endif /* LCP_HPP_ */
@@ -91,7 +91,7 @@ namespace rlxalgo {
        * at the beginning of a thread must not be identical
        * to the trigram at the end of the previous thread.) */
       portions.assign(
-          start,end,portions.num(),
+          start,end,portions.threads(),
           [&eq](It /*beg*/,It it,It end)
           {
             if (it != end) {
@@ -0,0 +1,342 @@
+/*
+ * qgram.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef QGRAM_HPP_
+#define QGRAM_HPP_
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "alphabet.hpp"
+#include "trigram.hpp"
+#include "../util/parallelization.hpp"
+
+namespace sux {
+
+  /**
+   * A q-gram of compile-time length `Q`: The text position it starts at
+   * and its `Q` characters. This generalises the trigrams of
+   * trigram.hpp, which remain the specialised implementation for Q=3.
+   */
+  template <unsigned Q, typename Char, typename Pos>
+  struct QGram
+  {
+    static_assert(Q > 0,"A q-gram must have at least one character");
+
+    typedef Char                  char_type;
+    typedef Pos                   pos_type;
+    typedef std::array<Char,Q>    chars_type;
+    static constexpr unsigned     length = Q;
+
+    Pos        _pos;
+    chars_type _chars;
+
+    QGram()
+    : _pos(), _chars()
+    { }
+
+    QGram(const Pos pos, const chars_type &chars)
+    : _pos(pos), _chars(chars)
+    { }
+
+    pos_type  pos() const                { return _pos; }
+    char_type get(const unsigned k) const { return _chars[k]; }
+
+    bool operator==(const QGram &other) const
+    { return (_pos == other._pos && _chars == other._chars); }
+
+    bool content_equal(const QGram &other) const
+    { return (_chars == other._chars); }
+  };
+
+  /**
+   * Return character `K` of a q-gram (the counterpart of `triget1()`
+   * etc. for trigrams).
+   */
+  template <unsigned K, unsigned Q, typename Char, typename Pos>
+  static Char qget(const QGram<Q,Char,Pos> &qgram)
+  {
+    static_assert(K < Q,"Attempt to access a character beyond the end of a q-gram");
+    return std::get<K>(qgram._chars);
+  }
+
+  namespace qgram_tools {
+
+    /**
+     * The number of complete q-grams of a text of the given length.
+     */
+    constexpr std::size_t num_qgrams(std::size_t length, unsigned q)
+    { return (length < q ? 0 : length - q + 1); }
+
+    /**
+     * The number of bits needed to represent the characters of a
+     * zero-range alphabet of `size` characters.
+     */
+    inline unsigned char_bits(std::size_t size)
+    {
+      unsigned bits
+      { 0 };
+      while ((bits < sizeof(std::size_t) * CHAR_BIT) && ((size - 1) >> bits) != 0)
+        ++bits;
+      return (bits == 0 ? 1 : bits);
+    }
+
+    /**
+     * Count the distinct q-grams of a sorted list of q-grams.
+     * @return One entry for each distinct q-gram, with the position of
+     *   its first occurrence in the list and its frequency.
+     */
+    template <typename QGramT, typename Freq = std::size_t>
+    std::vector<std::pair<QGramT,Freq>> frequencies(const std::vector<QGramT> &sorted)
+    {
+      std::vector<std::pair<QGramT,Freq>> result
+      { };
+      for (const QGramT &qgram : sorted)
+        if (!result.empty() && result.back().first.content_equal(qgram))
+          ++result.back().second;
+        else
+          result.emplace_back(qgram,Freq(1));
+      return result;
+    }
+
+  }
+
+  template <unsigned Q, typename Char, typename Pos>
+  struct QGramMaker
+  {
+    typedef QGram<Q,Char,Pos>            qgram_type;
+    typedef std::vector<qgram_type>      qgram_vec_type;
+    typedef Pos                          pos_type;
+
+    /**
+     * Create the q-gram that starts at text position `pos`, which
+     * `it` points to.
+     */
+    template <typename Iterator>
+    static qgram_type make_at(Iterator it, Pos pos)
+    {
+      typename qgram_type::chars_type chars;
+      for (unsigned k = 0 ; k < Q ; ++k, ++it)
+        chars[k] = *it;
+      return qgram_type(pos,chars);
+    }
+
+    /**
+     * Generate the complete q-grams starting at all positions of the
+     * text [from,to), in text order.
+     */
+    template <typename Iterator>
+    static qgram_vec_type make_qgrams(Iterator from, Iterator to)
+    { return make_qgrams(from,to,1); }
+
+    /**
+     * Parallel version of `make_qgrams(from,to)`, using the given number
+     * of threads. The result vector is allocated with its final size up
+     * front, and each thread fills its slice in place. The iterators
+     * must be random-access iterators.
+     */
+    template <typename Iterator>
+    static qgram_vec_type make_qgrams(Iterator from, Iterator to, unsigned threads)
+    {
+      using std::distance;
+
+      const std::size_t length
+      { static_cast<std::size_t>(distance(from,to)) };
+      if (static_cast<std::uintmax_t>(length) > std::numeric_limits<Pos>::max())
+        throw std::out_of_range("Attempt to generate q-grams for a text that is "
+            "too long for the position type");
+
+      qgram_vec_type result(qgram_tools::num_qgrams(length,Q));
+      if (result.empty())
+        return result;
+
+      const Iterator last
+      { std::next(from,result.size()) };
+      rlxutil::parallel::portions portions
+      { from , last , threads };
+      auto futs =
+          portions.apply(from,last,
+              [from,&result](Iterator local_from, Iterator local_to)
+              {
+                Pos pos
+                { static_cast<Pos>(distance(from,local_from)) };
+                auto out = result.begin() + pos;
+                for ( ; local_from != local_to ; ++local_from, ++pos)
+                  *(out++) = make_at(local_from,pos);
+              });
+      rlxutil::parallel::tools::wait_for(futs);
+      return result;
+    }
+
+    /**
+     * Create the q-grams for a list of text positions, using parallel
+     * threads. The q-grams are in the order of the positions.
+     */
+    template <typename Iterator, typename PosVector>
+    static qgram_vec_type from_positions(
+        Iterator text_from, const PosVector &positions, unsigned threads)
+    {
+      typedef typename PosVector::const_iterator pos_it;
+
+      qgram_vec_type result(positions.size());
+      if (result.empty())
+        return result;
+
+      rlxutil::parallel::portions portions
+      { positions.begin() , positions.end() , threads };
+      auto futs =
+          portions.apply(positions.begin(),positions.end(),
+              [&positions,&result,text_from](pos_it from, pos_it to)
+              {
+                auto out = result.begin() + std::distance(positions.begin(),from);
+                for ( ; from != to ; ++from)
+                  *(out++) = make_at(std::next(text_from,*from),*from);
+              });
+      rlxutil::parallel::tools::wait_for(futs);
+      return result;
+    }
+  };
+
+  /**
+   * Lexicographic radix sorting of q-grams, or of any elements that
+   * provide `Q` characters each, using one or multiple threads. The
+   * sort is stable.
+   *
+   * For zero-range alphabets, several characters are combined into one
+   * radix digit of at most `max_digit_bits` bits, so the number of
+   * passes is Q divided by the number of characters per digit. E.g. for
+   * a four-letter alphabet, eight characters make up one digit.
+   */
+  template <unsigned Q, typename Char, typename Pos>
+  struct QGramSorter
+  {
+    typedef TrigramSorter<Char,Pos> pass_sorter;
+    typedef QGram<Q,Char,Pos>       qgram_type;
+
+    static constexpr unsigned max_digit_bits = pass_sorter::max_digit_bits;
+
+    /**
+     * The number of characters of a zero-range alphabet of `size`
+     * characters that are combined into one radix digit.
+     */
+    static unsigned chars_per_digit(std::size_t size)
+    {
+      const unsigned bits
+      { qgram_tools::char_bits(size) };
+      const unsigned per_digit
+      { (bits >= max_digit_bits ? 1 : max_digit_bits / bits) };
+      return (per_digit < Q ? per_digit : Q);
+    }
+
+    /**
+     * Sort `data` by the `Q` characters `char_at(elem,0)` ...
+     * `char_at(elem,Q-1)` of each element, one radix pass per
+     * character, least significant first.
+     */
+    template <typename Vector, typename CharAt, typename AlphabetType>
+    static void sort_by(
+        Vector &data, CharAt char_at, const AlphabetType &alphabet, unsigned threads)
+    {
+      typedef typename Vector::value_type elem_type;
+
+      rlxutil::parallel::portions portions
+      { data.begin() , data.end() , threads };
+      Vector temp(data.size());
+      for (unsigned k = Q ; k-- > 0 ; )
+        pass_sorter::lsd_pass(data,temp,
+            [&char_at,k](const elem_type &elem) { return char_at(elem,k); },alphabet,portions);
+    }
+
+    /**
+     * Sorting for zero-range alphabets: Each radix pass sorts by a digit
+     * made of several consecutive characters (see `chars_per_digit()`).
+     */
+    template <typename Vector, typename CharAt, typename AlphaChar, typename Freq>
+    static void sort_by(
+        Vector &data, CharAt char_at,
+        const rlx::Alphabet<rlx::AlphabetClass::zero_range,AlphaChar,Freq> &alphabet,
+        unsigned threads)
+    {
+      typedef typename Vector::value_type                           elem_type;
+      typedef std::uint_fast32_t                                    digit_type;
+      typedef rlx::Alphabet<rlx::AlphabetClass::zero_range,digit_type,Freq> digit_alphabet_type;
+
+      rlxutil::parallel::portions portions
+      { data.begin() , data.end() , threads };
+      Vector temp(data.size());
+
+      const unsigned per_digit
+      { chars_per_digit(alphabet._highest) };
+      if (per_digit == 1)
+        {
+          for (unsigned k = Q ; k-- > 0 ; )
+            pass_sorter::lsd_pass(data,temp,
+                [&char_at,k](const elem_type &elem) { return char_at(elem,k); },alphabet,portions);
+          return;
+        }
+
+      const unsigned bits
+      { qgram_tools::char_bits(alphabet._highest) };
+      for (unsigned end = Q ; end > 0 ; )
+        {
+          const unsigned begin
+          { (end > per_digit ? end - per_digit : 0) };
+          const digit_alphabet_type digit_alphabet
+          { std::size_t(1) << (bits * (end - begin)) };
+          pass_sorter::lsd_pass(data,temp,
+              [&char_at,begin,end,bits](const elem_type &elem)
+              {
+                digit_type digit
+                { 0 };
+                for (unsigned k = begin ; k < end ; ++k)
+                  digit = (digit << bits) | static_cast<digit_type>(char_at(elem,k));
+                return digit;
+              },
+              digit_alphabet,portions);
+          end = begin;
+        }
+    }
+
+    /**
+     * Sort a list of q-grams lexicographically.
+     */
+    template <typename AlphabetType>
+    static void sort_qgrams(
+        std::vector<qgram_type> &qgrams, const AlphabetType &alphabet, unsigned threads)
+    {
+      sort_by(qgrams,
+          [](const qgram_type &qgram, unsigned k) { return qgram._chars[k]; },
+          alphabet,threads);
+    }
+
+    /**
+     * Sort a list of text positions by the q-grams starting at them.
+     * `text` must be random-accessible at every position `pos+k` with
+     * `pos` in `positions` and `k < Q`.
+     */
+    template <typename Text, typename AlphabetType>
+    static void sort_positions(
+        std::vector<Pos> &positions, const Text &text,
+        const AlphabetType &alphabet, unsigned threads)
+    {
+      sort_by(positions,
+          [&text](const Pos pos, unsigned k) { return text[pos + k]; },
+          alphabet,threads);
+    }
+  };
+
+}
+
+#endif /* QGRAM_HPP_ */
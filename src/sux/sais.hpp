@@ -0,0 +1,269 @@
+/*
+ * sais.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef SAIS_HPP_
+#define SAIS_HPP_
+
+#include <limits>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <vector>
+
+#include "../util/parallelization.hpp"
+#include "alphabet.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * Suffix array construction by induced sorting (SA-IS), as described
+   * by Nong, Zhang and Chan (2009). Compared to the skew algorithm, the
+   * working memory is small: apart from the suffix array itself, only
+   * one bit per character and the reduced string of the recursion
+   * (at most half the length of the text) are needed.
+   */
+  namespace sais {
+
+    template <typename... Ts> using sequence = std::vector<Ts...>;
+
+    /**
+     * The bucket boundaries of the first `length` characters of `text`,
+     * whose characters are in [0,highest]: The bucket of character `c`
+     * is [buckets[c],buckets[c+1]). The characters are counted by
+     * `threads` parallel threads.
+     */
+    template <typename Pos, typename Char>
+    sequence<Pos> make_buckets(
+        const sequence<Char> &text, std::size_t length, std::size_t highest, unsigned threads)
+    {
+      typedef rlx::Alphabet<rlx::AlphabetClass::zero_range,Char,Pos> alphabet_type;
+      typedef typename sequence<Char>::const_iterator                 textit;
+
+      const alphabet_type alphabet
+      { highest + 1 };
+      auto char_id = [](const Char c) { return c; };
+
+      rlxutil::parallel::portions portions
+      { text.begin() , text.begin() + length , threads };
+      auto futs = portions.apply(text.begin(),text.begin() + length,
+          rlx::alphabet_tools::make_freq_table<textit,decltype(char_id),alphabet_type>,
+          char_id,alphabet);
+
+      auto buckets = alphabet.new_freq_table();
+      for (auto &fut : futs)
+        alphabet_type::add_char_freq_table(buckets,fut.get(),threads);
+      alphabet_type::make_cumulative(buckets);
+      buckets.push_back(static_cast<Pos>(length));
+      return buckets;
+    }
+
+    /**
+     * Induce the order of the L-type suffixes from the suffixes already
+     * in `sux_array` (scanning left to right), and then the order of the
+     * S-type suffixes (scanning right to left).
+     */
+    template <typename Pos, typename Char>
+    void induce(
+        const sequence<Char>    &text,
+        const std::vector<bool> &stype,
+        const sequence<Pos>     &buckets,
+        sequence<Pos>           &sux_array)
+    {
+      const Pos empty
+      { std::numeric_limits<Pos>::max() };
+
+      sequence<Pos> heads(buckets.begin(),buckets.end() - 1);
+      for (std::size_t i = 0 ; i < sux_array.size() ; ++i)
+        {
+          const Pos pos = sux_array[i];
+          if (pos != empty && pos > 0 && !stype[pos - 1])
+            sux_array[heads[text[pos - 1]]++] = pos - 1;
+        }
+
+      sequence<Pos> tails(buckets.begin() + 1,buckets.end());
+      for (std::size_t i = sux_array.size() ; i-- > 0 ; )
+        {
+          const Pos pos = sux_array[i];
+          if (pos != empty && pos > 0 && stype[pos - 1])
+            sux_array[--tails[text[pos - 1]]] = pos - 1;
+        }
+    }
+
+    /**
+     * Compute the suffix array of the first `length` characters of `text`.
+     * The characters must be in [0,highest], and the last of them (at
+     * position `length-1`) must be a 0-sentinel that occurs nowhere else.
+     */
+    template <typename Pos, typename Char>
+    sequence<Pos> induced_sort(
+        const sequence<Char> &text, std::size_t length, std::size_t highest, unsigned threads)
+    {
+      using std::size_t;
+
+      const Pos empty
+      { std::numeric_limits<Pos>::max() };
+
+      sequence<Pos> sux_array(length,empty);
+      if (length == 1)
+        {
+          sux_array[0] = 0;
+          return sux_array;
+        }
+
+      /* Suffix types: S-type if smaller than the following suffix. A
+       * leftmost S-type (LMS) position is an S-type position preceded
+       * by an L-type one. */
+      std::vector<bool> stype(length);
+      stype[length - 1] = true;
+      for (size_t i = length - 1 ; i-- > 0 ; )
+        stype[i] = (text[i] < text[i + 1] || (text[i] == text[i + 1] && stype[i + 1]));
+      auto is_lms = [&stype](size_t pos) { return (pos > 0 && stype[pos] && !stype[pos - 1]); };
+
+      const sequence<Pos> buckets = make_buckets<Pos>(text,length,highest,threads);
+
+      /* Sort the LMS substrings: Place the LMS positions at the ends of
+       * their buckets, and induce. */
+      {
+        sequence<Pos> tails(buckets.begin() + 1,buckets.end());
+        for (size_t pos = 1 ; pos < length ; ++pos)
+          if (is_lms(pos))
+            sux_array[--tails[text[pos]]] = static_cast<Pos>(pos);
+      }
+      induce(text,stype,buckets,sux_array);
+
+      /* Move the sorted LMS positions to the front. */
+      size_t num_lms
+      { 0 };
+      for (size_t i = 0 ; i < length ; ++i)
+        if (is_lms(sux_array[i]))
+          sux_array[num_lms++] = sux_array[i];
+
+      /* Name the LMS substrings in sorted order. Equal substrings get
+       * equal names. The name of the substring at `pos` is stored at
+       * `num_lms + pos/2`; as LMS positions are at least two apart,
+       * these slots do not collide. */
+      std::fill(sux_array.begin() + num_lms,sux_array.end(),empty);
+      size_t names
+      { 0 };
+      Pos prev
+      { empty };
+      for (size_t i = 0 ; i < num_lms ; ++i)
+        {
+          const Pos pos = sux_array[i];
+          bool differ
+          { prev == empty };
+          for (size_t d = 0 ; !differ ; ++d)
+            {
+              if (text[pos + d] != text[prev + d] || stype[pos + d] != stype[prev + d])
+                differ = true;
+              else if (d > 0 && (is_lms(pos + d) || is_lms(prev + d)))
+                break;
+            }
+          if (differ)
+            {
+              ++names;
+              prev = pos;
+            }
+          sux_array[num_lms + pos / 2] = static_cast<Pos>(names - 1);
+        }
+
+      /* The reduced string: The names of the LMS substrings in text
+       * order. It ends with the name of the sentinel, which is 0. */
+      sequence<Pos> reduced(num_lms);
+      for (size_t i = num_lms, j = 0 ; i < length ; ++i)
+        if (sux_array[i] != empty)
+          reduced[j++] = sux_array[i];
+
+      /* Sort the LMS suffixes, by recursion if the names are not
+       * unique. */
+      sequence<Pos> reduced_sa;
+      if (names < num_lms)
+        reduced_sa = induced_sort<Pos>(reduced,num_lms,names - 1,threads);
+      else
+        {
+          reduced_sa.resize(num_lms);
+          for (size_t i = 0 ; i < num_lms ; ++i)
+            reduced_sa[reduced[i]] = static_cast<Pos>(i);
+        }
+
+      /* Map the reduced suffix array back to LMS positions. */
+      for (size_t pos = 1, j = 0 ; pos < length ; ++pos)
+        if (is_lms(pos))
+          reduced[j++] = static_cast<Pos>(pos);
+      for (auto &entry : reduced_sa)
+        entry = reduced[entry];
+      reduced = sequence<Pos>();
+
+      /* Place the sorted LMS suffixes at the ends of their buckets,
+       * keeping their order, and induce the final suffix array. */
+      std::fill(sux_array.begin(),sux_array.end(),empty);
+      {
+        sequence<Pos> tails(buckets.begin() + 1,buckets.end());
+        for (size_t i = num_lms ; i-- > 0 ; )
+          {
+            const Pos pos = reduced_sa[i];
+            sux_array[--tails[text[pos]]] = pos;
+          }
+      }
+      reduced_sa = sequence<Pos>();
+      induce(text,stype,buckets,sux_array);
+
+      return sux_array;
+    }
+
+    /**
+     * Calls `induced_sort()` for texts of any character type (see
+     * `rlx::alphabet_tools::with_sentinel_text()`), and removes the
+     * sentinel from the result.
+     */
+    template <typename Pos>
+    struct padded_builder
+    {
+      unsigned _threads;
+
+      template <typename Char>
+      sequence<Pos> operator()(const sequence<Char> &text, std::size_t length, std::size_t highest) const
+      {
+        sequence<Pos> sux_array = induced_sort<Pos>(text,length + 1,highest,_threads);
+        sux_array.erase(sux_array.begin());
+        return sux_array;
+      }
+    };
+
+    /**
+     * Compute the suffix array of the text [from,to) using SA-IS. The
+     * interface is that of `skew::make_suffix_array()`. Character
+     * counting and alphabet compaction use `threads` parallel threads;
+     * induced sorting itself is sequential.
+     */
+    template <typename Pos, typename It>
+    sequence<Pos> make_suffix_array(It from, It to, unsigned threads = 4)
+    {
+      using std::numeric_limits;
+      using std::uintmax_t;
+
+      static_assert(std::is_integral<Pos>::value,
+          "The position type used for make_suffix_array must be an integral type.");
+      /* The largest value is reserved as empty marker. */
+      if (static_cast<uintmax_t>(numeric_limits<Pos>::max())
+          < static_cast<uintmax_t>(std::distance(from,to)) + 2)
+        throw std::out_of_range("Attempt to use a position type with make_suffix_array that "
+            "is not large enough for the given input string");
+
+      return rlx::alphabet_tools::with_sentinel_text<Pos>(from,to,1,threads,
+          padded_builder<Pos>
+          { threads });
+    }
+
+  } // sais
+
+} // rlxalgo
+
+
+#endif /* SAIS_HPP_ */
@@ -0,0 +1,182 @@
+/*
+ * sampled_sa.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef SAMPLED_SA_HPP_
+#define SAMPLED_SA_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../util/more_type_traits.hpp"
+#include "../util/parallelization.hpp"
+#include "suffix_array.hpp"
+#include "fm_index.hpp"
+#include "bitvector.hpp"
+
+namespace rlxalgo {
+
+  namespace fm {
+
+    /**
+     * A compressed suffix array: The FM-index of a text together with
+     * the suffix array values of the text positions divisible by the
+     * sampling rate s. The rows that hold a sample are marked in a
+     * `succinct::bitvector`, and the samples are stored in row order, so
+     * the sample of a marked row is found by a rank query. Any other
+     * value is recovered by following the LF mapping to the next marked
+     * row, which takes at most s-1 steps.
+     *
+     * The samples take n/s positions, and the marks n bits plus their
+     * rank directory, instead of the n positions of the full suffix
+     * array.
+     */
+    template <typename Char, typename Pos>
+    class sampled_suffix_array
+    {
+    public:
+      typedef fm_index<Char,Pos>      index_type;
+      typedef Pos                     pos_type;
+      typedef search::sa_interval<Pos> interval_type;
+
+      sampled_suffix_array()
+      : _rate(1), _index(), _marks(), _samples()
+      { }
+
+      /**
+       * Build the compressed suffix array of the text [from,to) with
+       * sampling rate `rate`, given its suffix array. The FM-index, the
+       * marks and the samples are all derived from the suffix array
+       * in memory, which the caller may release afterwards.
+       */
+      template <typename It>
+      sampled_suffix_array(
+          It from, It to, const std::vector<Pos> &sux_array, Pos rate, unsigned threads = 4)
+      : _rate(rate), _index(from,to,sux_array,threads), _marks(), _samples()
+      {
+        using std::distance;
+        using rlxutil::parallel::tools::wait_for;
+        typedef typename std::vector<Pos>::const_iterator saiter;
+
+        if (rate == 0)
+          throw std::invalid_argument("The sampling rate of a suffix array must be positive");
+
+        /* Row r of the BWT holds the suffix sux_array[r-1]. */
+        _marks = succinct::bitvector(sux_array.size() + 1,
+            [&sux_array,rate](std::size_t row)
+            { return (row > 0 && sux_array[row - 1] % rate == 0); },
+            threads);
+
+        _samples.resize(_marks.ones());
+        if (_samples.empty())
+          return;
+        rlxutil::parallel::portions portions
+        { sux_array.begin() , sux_array.end() , threads };
+        auto futs = portions.apply(sux_array.begin(),sux_array.end(),
+            [this,&sux_array,rate](saiter sa_from, saiter sa_to)
+            {
+              auto dest = _samples.begin()
+                  + _marks.rank1(static_cast<std::size_t>(distance(sux_array.begin(),sa_from)) + 1);
+              for ( ; sa_from != sa_to ; ++sa_from)
+                if (*sa_from % rate == 0)
+                  *dest++ = *sa_from;
+            });
+        wait_for(futs);
+      }
+
+      /** The length of the text. */
+      Pos size() const              { return _index.size(); }
+      Pos sampling_rate() const     { return _rate; }
+      const index_type &index() const { return _index; }
+
+      /**
+       * The suffix array value at position `i`, for i < size().
+       */
+      Pos operator[](const Pos i) const
+      { return at_row(i + 1); }
+
+      template <typename PatIt>
+      interval_type find(PatIt from, PatIt to) const
+      { return _index.find(from,to); }
+
+      template <typename Pattern>
+      interval_type find(const Pattern &pattern) const
+      { return _index.find(pattern); }
+
+      template <typename Pattern>
+      Pos count(const Pattern &pattern) const
+      { return _index.count(pattern); }
+
+      /**
+       * The text positions of the occurrences of the pattern, in suffix
+       * array order.
+       */
+      template <typename Pattern>
+      std::vector<Pos> locate(const Pattern &pattern) const
+      {
+        const interval_type interval
+        { find(pattern) };
+        std::vector<Pos> result;
+        result.reserve(interval.size());
+        for (Pos i = interval._begin ; i < interval._end ; ++i)
+          result.push_back((*this)[i]);
+        return result;
+      }
+
+      /**
+       * The memory used by the FM-index, the marks and the samples, in
+       * bytes.
+       */
+      std::size_t size_in_bytes() const
+      {
+        return sizeof(*this) - sizeof(_index) - sizeof(_marks)
+            + _index.size_in_bytes()
+            + _marks.size_in_bytes()
+            + _samples.size() * sizeof(Pos);
+      }
+
+    private:
+      Pos at_row(Pos row) const
+      {
+        Pos steps
+        { 0 };
+        while (!_marks[row])
+          {
+            row = _index.lf(row);
+            ++steps;
+          }
+        return _samples[_marks.rank1(row)] + steps;
+      }
+
+      Pos                 _rate;
+      index_type          _index;
+      succinct::bitvector _marks;
+      std::vector<Pos>    _samples;
+    };
+
+    /**
+     * Build the compressed suffix array of the text [from,to) with
+     * sampling rate `rate`. The full suffix array is built with the
+     * given engine and released before this returns; it is never
+     * written out.
+     */
+    template <typename Pos, SAEngine engine = SAEngine::skew, typename It>
+    sampled_suffix_array<typename std::remove_cv<rlxtype::deref<It>>::type,Pos>
+    make_sampled_suffix_array(It from, It to, Pos rate, unsigned threads = 4)
+    {
+      return { from , to ,
+        make_suffix_array<Pos,engine>(from,to,threads) , rate , threads };
+    }
+
+  } // fm
+
+} // rlxalgo
+
+
+#endif /* SAMPLED_SA_HPP_ */
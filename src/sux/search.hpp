@@ -0,0 +1,735 @@
+/*
+ * search.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef SEARCH_HPP_
+#define SEARCH_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include <vector>
+
+#include "../util/more_type_traits.hpp"
+#include "../util/parallelization.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * Pattern search in a text using its suffix array: The suffixes that
+   * begin with the pattern form an interval of the suffix array, which
+   * is found by binary search (Manber and Myers 1993).
+   */
+  namespace search {
+
+    /**
+     * An interval [_begin,_end) of the suffix array.
+     */
+    template <typename Pos>
+    struct sa_interval
+    {
+      Pos _begin;
+      Pos _end;
+
+      Pos  size() const  { return _end - _begin; }
+      bool empty() const { return (_begin == _end); }
+
+      bool operator==(const sa_interval &other) const
+      { return (_begin == other._begin && _end == other._end); }
+    };
+
+    /**
+     * Lookup table that maps every string of `k` characters (k-mer) of
+     * a byte alphabet to its interval of the suffix array, i.e. to the
+     * suffixes that begin with it. A search for a pattern of length at
+     * least `k` starts with a table lookup instead of the first log(n)
+     * steps of the binary search, which are the ones most likely to
+     * cause cache and TLB misses. The table has 256^k + 1 entries.
+     */
+    template <typename Pos>
+    class kmer_table
+    {
+    public:
+      typedef sa_interval<Pos> interval_type;
+
+      /** The largest supported `k`; the table then has 16m entries. */
+      static constexpr unsigned max_k = 3;
+
+      kmer_table()
+      : _k(0), _bounds(), _short_keys()
+      { }
+
+      /**
+       * Build the table for the text [from,to) with suffix array
+       * `sux_array`. The suffix array is scanned in parallel portions;
+       * each pair of neighbouring suffixes fills the table entries of
+       * the k-mers that lie between them.
+       */
+      template <typename It>
+      kmer_table(It from, It to, const std::vector<Pos> &sux_array, unsigned k, unsigned threads = 4)
+      : _k(k), _bounds(), _short_keys()
+      {
+        using rlxutil::parallel::tools::wait_for;
+        typedef typename std::vector<Pos>::const_iterator saiter;
+        static_assert(sizeof(rlxtype::deref<It>) == 1,
+            "k-mer tables can only be built for texts of a byte alphabet");
+
+        if (k == 0 || k > max_k)
+          throw std::invalid_argument("The k of a k-mer table must be in [1,3]");
+        const std::size_t length
+        { sux_array.size() };
+        if (static_cast<std::size_t>(std::distance(from,to)) != length)
+          throw std::invalid_argument("The suffix array passed to the k-mer table does not "
+              "match the length of the text");
+
+        const std::size_t num_kmers
+        { std::size_t(1) << (8 * k) };
+        _bounds.resize(num_kmers + 1);
+
+        /* Bound of a suffix: Every k-mer smaller than it is counted by
+         * the table entries before that of the suffix. A suffix of at
+         * least k characters is greater than or equal to its own k-mer
+         * and the ones before; a shorter suffix, padded with character
+         * 0, only to the ones before. */
+        auto bound_of = [from,length,k](std::size_t pos) -> std::size_t
+        {
+          std::size_t code
+          { 0 };
+          for (unsigned j = 0 ; j < k ; ++j)
+            code = (code << 8) | (pos + j < length ? kmer_table::byte_of(from[pos + j]) : 0);
+          return (pos + k <= length ? code + 1 : code);
+        };
+
+        if (length > 0)
+          {
+            rlxutil::parallel::portions portions
+            { sux_array.begin() , sux_array.end() , threads };
+            auto futs = portions.apply(sux_array.begin(),sux_array.end(),
+                [this,&bound_of](saiter sa_from, saiter sa_to, saiter sa_beg)
+                {
+                  std::size_t prev_bound
+                  { sa_from == sa_beg ? 0 : bound_of(*std::prev(sa_from)) };
+                  for ( ; sa_from != sa_to ; ++sa_from)
+                    {
+                      const std::size_t bound = bound_of(*sa_from);
+                      const Pos index = static_cast<Pos>(std::distance(sa_beg,sa_from));
+                      for (std::size_t code = prev_bound ; code < bound ; ++code)
+                        _bounds[code] = index;
+                      prev_bound = bound;
+                    }
+                },sux_array.begin());
+            wait_for(futs);
+          }
+        for (std::size_t code = (length > 0 ? bound_of(sux_array.back()) : 0) ;
+            code <= num_kmers ; ++code)
+          _bounds[code] = static_cast<Pos>(length);
+
+        for (std::size_t pos = (length >= k ? length - k + 1 : 0) ; pos < length ; ++pos)
+          _short_keys.push_back(bound_of(pos));
+      }
+
+      unsigned k() const
+      { return _k; }
+
+      bool empty() const
+      { return _bounds.empty(); }
+
+      /**
+       * The interval of the suffixes that begin with the k characters
+       * starting at `kmer`.
+       */
+      template <typename PatIt>
+      interval_type find(PatIt kmer) const
+      {
+        std::size_t code
+        { 0 };
+        for (unsigned j = 0 ; j < _k ; ++j)
+          code = (code << 8) | byte_of(kmer[j]);
+        /* The table entry of the next k-mer also counts the suffixes
+         * shorter than k that are greater than this k-mer, but whose
+         * padded form is not. */
+        Pos end
+        { _bounds[code + 1] };
+        for (const std::size_t short_key : _short_keys)
+          if (short_key == code + 1)
+            --end;
+        return { _bounds[code] , end };
+      }
+
+    private:
+      unsigned                 _k;
+      /** For each k-mer, the number of suffixes smaller than it. */
+      std::vector<Pos>         _bounds;
+      /** The padded k-mers of the k-1 suffixes shorter than k. */
+      std::vector<std::size_t> _short_keys;
+
+      /** Map a byte to [0,256) so that the order of characters is kept. */
+      template <typename Char>
+      static std::size_t byte_of(const Char c)
+      {
+        typedef typename std::make_unsigned<Char>::type uchar_type;
+        return static_cast<std::size_t>(static_cast<uchar_type>(c)
+            ^ (std::is_signed<Char>::value ? 0x80 : 0));
+      }
+    };
+
+    /**
+     * Searching a text using its suffix array. The text can be any
+     * random-access sequence, e.g. a `std::string` or a vector of
+     * integer tokens, and patterns are given as random-access ranges over
+     * elements that compare with those of the text.
+     *
+     * Without an LCP array, the binary search uses the mlr heuristic:
+     * the first min(l,r) characters of the pattern are known to match
+     * the suffix in the middle, where l and r are the lengths of the
+     * matches at the interval boundaries. Given the LCP array, the
+     * longest common prefixes of each middle suffix with the boundaries
+     * of its search interval (Llcp and Rlcp) are precomputed, so each
+     * character of the pattern is compared at most once per search,
+     * i.e. O(m + log n) time. This takes 2n additional positions.
+     *
+     * The text and the suffix array are referenced, not copied. The
+     * search functions do not allocate memory.
+     */
+    template <typename Text, typename Pos>
+    class sa_searcher
+    {
+    public:
+      typedef sa_interval<Pos>                       interval_type;
+      typedef typename std::vector<Pos>::const_iterator const_iterator;
+
+      sa_searcher(const Text &text, const std::vector<Pos> &sux_array)
+      : _text(text), _sux_array(sux_array), _llcp(), _rlcp(), _kmers()
+      { check_input(); }
+
+      sa_searcher(const Text &text, const std::vector<Pos> &sux_array, const std::vector<Pos> &lcp)
+      : _text(text), _sux_array(sux_array), _llcp(), _rlcp(), _kmers()
+      {
+        check_input();
+        if (lcp.size() != sux_array.size())
+          throw std::invalid_argument("The LCP array passed to sa_searcher does not "
+              "match the suffix array");
+        _llcp.resize(sux_array.size());
+        _rlcp.resize(sux_array.size());
+        make_boundary_lcps(lcp,-1,static_cast<std::ptrdiff_t>(sux_array.size()));
+      }
+
+      /** The suffix array is referenced, so it must not be a temporary. */
+      sa_searcher(const Text &, std::vector<Pos> &&) = delete;
+      sa_searcher(const Text &, std::vector<Pos> &&, const std::vector<Pos> &) = delete;
+
+      /**
+       * Build a k-mer table (see `kmer_table`), which is then used for
+       * all patterns of at least `k` characters. Within the interval of
+       * the k-mer, the search uses the mlr heuristic, as the Llcp/Rlcp
+       * values do not apply to it. The text must consist of bytes.
+       */
+      void make_kmer_table(unsigned k, unsigned threads = 4)
+      { _kmers = kmer_table<Pos>(std::begin(_text),std::end(_text),_sux_array,k,threads); }
+
+      /**
+       * The interval of the suffix array holding the suffixes that begin
+       * with the pattern [from,to). The empty pattern matches all
+       * suffixes.
+       */
+      template <typename PatIt>
+      interval_type find(PatIt from, PatIt to) const
+      {
+        const std::size_t pat_len
+        { static_cast<std::size_t>(std::distance(from,to)) };
+        if (!_kmers.empty() && pat_len >= _kmers.k())
+          {
+            /* All suffixes of the k-mer interval share the first k
+             * characters with the pattern. */
+            const interval_type kmer_interval
+            { _kmers.find(from) };
+            if (pat_len == _kmers.k() || kmer_interval.empty())
+              return kmer_interval;
+            const Pos lower
+            { bound<false>(from,to,static_cast<std::ptrdiff_t>(kmer_interval._begin) - 1,_kmers.k(),
+                kmer_interval._end,_kmers.k(),false) };
+            const Pos upper
+            { bound<true>(from,to,static_cast<std::ptrdiff_t>(lower) - 1,_kmers.k(),
+                kmer_interval._end,_kmers.k(),false) };
+            return { lower , upper };
+          }
+
+        const Pos lower
+        { bound<false>(from,to,-1,0,static_cast<std::ptrdiff_t>(_sux_array.size()),0,!_llcp.empty()) };
+        /* The Llcp/Rlcp arrays describe the search intervals that
+         * start from the whole suffix array. Without them, the upper
+         * bound is searched to the right of the lower bound only. */
+        const std::ptrdiff_t upper_left
+        { _llcp.empty() ? static_cast<std::ptrdiff_t>(lower) - 1 : -1 };
+        const Pos upper
+        { bound<true>(from,to,upper_left,0,static_cast<std::ptrdiff_t>(_sux_array.size()),0,!_llcp.empty()) };
+        return { lower , upper };
+      }
+
+      template <typename Pattern>
+      interval_type find(const Pattern &pattern) const
+      { return find(std::begin(pattern),std::end(pattern)); }
+
+      /** The number of occurrences of the pattern [from,to). */
+      template <typename PatIt>
+      Pos count(PatIt from, PatIt to) const
+      { return find(from,to).size(); }
+
+      template <typename Pattern>
+      Pos count(const Pattern &pattern) const
+      { return find(pattern).size(); }
+
+      /**
+       * The text positions of the occurrences of the pattern [from,to),
+       * as a range of the suffix array. The positions are in the order
+       * of the suffixes, not in text order.
+       */
+      template <typename PatIt>
+      std::pair<const_iterator,const_iterator> locate(PatIt from, PatIt to) const
+      { return positions(find(from,to)); }
+
+      template <typename Pattern>
+      std::pair<const_iterator,const_iterator> locate(const Pattern &pattern) const
+      { return positions(find(pattern)); }
+
+      /** The number of searches `find_batch()` runs in lockstep. */
+      static constexpr std::size_t batch_window = 16;
+
+      /**
+       * Find the suffix array intervals of all patterns in [first,last),
+       * which are containers such as strings or token vectors. This is
+       * faster than calling `find()` for each of them when there are
+       * many patterns:
+       *
+       *  - Up to `batch_window` binary searches run interleaved. Each
+       *    step of a search prefetches what its next step reads (the
+       *    suffix array entry of the next probe, then the text at that
+       *    suffix), and the other searches run while the memory is
+       *    loaded.
+       *  - The patterns are searched in sorted order, so the lower
+       *    bound of the patterns searched before bounds the search from
+       *    the left, and the interval of an earlier pattern that is a
+       *    prefix of the current one bounds it on both sides. Repeated
+       *    patterns are searched only once.
+       *
+       * The k-mer table is used if present; the Llcp/Rlcp values are
+       * not, as the search intervals are narrowed in other ways.
+       * @return The intervals, in the order of the patterns.
+       */
+      template <typename PatternIt>
+      std::vector<interval_type> find_batch(PatternIt first, PatternIt last) const
+      {
+        using std::begin;
+        using std::end;
+
+        const std::size_t num_patterns
+        { static_cast<std::size_t>(std::distance(first,last)) };
+        std::vector<interval_type> result(num_patterns);
+
+        std::vector<std::size_t> order(num_patterns);
+        for (std::size_t i = 0 ; i < num_patterns ; ++i)
+          order[i] = i;
+        std::sort(order.begin(),order.end(),
+            [first](std::size_t i1, std::size_t i2)
+            { return std::lexicographical_compare(
+                begin(first[i1]),end(first[i1]),begin(first[i2]),end(first[i2])); });
+
+        std::vector<char> done(num_patterns,0);
+        std::vector<batch_search> window(batch_window);
+        std::size_t next_rank
+        { 0 };
+        std::size_t active
+        { 0 };
+        Pos max_lower
+        { 0 };
+
+        while (next_rank < num_patterns || active > 0)
+          for (batch_search &search : window)
+            {
+              while (!search._active && next_rank < num_patterns)
+                {
+                  const std::size_t rank = next_rank++;
+                  if (start_search(search,rank,first[order[rank]],order,done,result,max_lower,first))
+                    ++active;
+                  else
+                    done[rank] = 1;
+                }
+              if (!search._active)
+                continue;
+              if (step_search(search,first[order[search._rank]]))
+                {
+                  result[order[search._rank]] = { search._lower , static_cast<Pos>(search._right) };
+                  done[search._rank] = 1;
+                  if (search._lower > max_lower)
+                    max_lower = search._lower;
+                  search._active = false;
+                  --active;
+                }
+            }
+
+        return result;
+      }
+
+      template <typename Patterns>
+      std::vector<interval_type> find_batch(const Patterns &patterns) const
+      { return find_batch(std::begin(patterns),std::end(patterns)); }
+
+      /** The text positions of a suffix array interval. */
+      std::pair<const_iterator,const_iterator> positions(const interval_type &interval) const
+      { return { _sux_array.begin() + interval._begin , _sux_array.begin() + interval._end }; }
+
+    private:
+      const Text             &_text;
+      const std::vector<Pos> &_sux_array;
+      std::vector<Pos>        _llcp;
+      std::vector<Pos>        _rlcp;
+      kmer_table<Pos>         _kmers;
+
+      /**
+       * The state of one search of `find_batch()`: The current interval
+       * (left,right) and the lengths of the matches at its boundaries,
+       * the probe in its middle, and the best boundaries for the upper
+       * bound seen while searching for the lower bound.
+       */
+      struct batch_search
+      {
+        bool           _active     = false;
+        bool           _upper      = false;
+        bool           _loaded     = false;
+        std::size_t    _rank       = 0;
+        std::ptrdiff_t _left       = 0;
+        std::ptrdiff_t _right      = 0;
+        std::size_t    _lcp_left   = 0;
+        std::size_t    _lcp_right  = 0;
+        std::ptrdiff_t _middle     = 0;
+        Pos            _pos        = 0;
+        Pos            _lower      = 0;
+        std::ptrdiff_t _upper_left      = 0;
+        std::size_t    _upper_lcp_left  = 0;
+        std::ptrdiff_t _upper_right     = 0;
+        std::size_t    _upper_lcp_right = 0;
+      };
+
+      static void prefetch(const void *addr)
+      { __builtin_prefetch(addr); }
+
+      /**
+       * Set up the search for the pattern of the given rank in sorted
+       * order, narrowed by the k-mer table and by the results of
+       * earlier patterns.
+       * @return false if the result is already known.
+       */
+      template <typename Pattern, typename PatternIt>
+      bool start_search(batch_search &search, std::size_t rank, const Pattern &pattern,
+          const std::vector<std::size_t> &order, const std::vector<char> &done,
+          std::vector<interval_type> &result, Pos max_lower, PatternIt first) const
+      {
+        using std::begin;
+        using std::end;
+
+        const std::size_t pat_len
+        { static_cast<std::size_t>(std::distance(begin(pattern),end(pattern))) };
+        std::ptrdiff_t left
+        { -1 };
+        std::ptrdiff_t right
+        { static_cast<std::ptrdiff_t>(_sux_array.size()) };
+        std::size_t known
+        { 0 };
+
+        if (!_kmers.empty() && pat_len >= _kmers.k())
+          {
+            const interval_type kmer_interval
+            { _kmers.find(begin(pattern)) };
+            left  = static_cast<std::ptrdiff_t>(kmer_interval._begin) - 1;
+            right = kmer_interval._end;
+            known = _kmers.k();
+          }
+
+        /* The nearest earlier pattern that is a prefix of this one. */
+        for (std::size_t prev = rank ; prev-- > 0 && rank - prev <= batch_window ; )
+          {
+            if (!done[prev])
+              continue;
+            const auto &prev_pattern = first[order[prev]];
+            const std::size_t prev_len
+            { static_cast<std::size_t>(std::distance(begin(prev_pattern),end(prev_pattern))) };
+            if (prev_len > pat_len || !std::equal(begin(prev_pattern),end(prev_pattern),begin(pattern)))
+              continue;
+            const interval_type &prev_interval = result[order[prev]];
+            if (prev_len == pat_len)
+              {
+                result[order[rank]] = prev_interval;
+                return false;
+              }
+            left  = std::max(left,static_cast<std::ptrdiff_t>(prev_interval._begin) - 1);
+            right = std::min(right,static_cast<std::ptrdiff_t>(prev_interval._end));
+            known = std::max(known,prev_len);
+            break;
+          }
+        left = std::max(left,static_cast<std::ptrdiff_t>(max_lower) - 1);
+
+        /* Every suffix strictly inside (left,right) shares `known`
+         * characters with the pattern. */
+        search._active    = true;
+        search._upper     = false;
+        search._rank      = rank;
+        search._left      = left;
+        search._right     = right;
+        search._lcp_left  = known;
+        search._lcp_right = known;
+        search._upper_left      = left;
+        search._upper_lcp_left  = known;
+        search._upper_right     = right;
+        search._upper_lcp_right = known;
+        if (right - left <= 1)
+          search._middle = -1;
+        else
+          {
+            search._middle = left + (right - left) / 2;
+            prefetch(&_sux_array[search._middle]);
+          }
+        search._loaded = false;
+        return true;
+      }
+
+      /**
+       * Perform one step of a search of `find_batch()`: Either load the
+       * suffix array entry of the probe and prefetch its text, or
+       * compare the pattern to the probe and prefetch the next one.
+       * @return true if the search is complete.
+       */
+      template <typename Pattern>
+      bool step_search(batch_search &search, const Pattern &pattern) const
+      {
+        using std::begin;
+        using std::end;
+
+        if (search._middle >= 0)
+          {
+            if (!search._loaded)
+              {
+                search._pos    = _sux_array[search._middle];
+                search._loaded = true;
+                prefetch(&*(begin(_text) + search._pos));
+                return false;
+              }
+
+            const std::size_t known
+            { std::min(search._lcp_left,search._lcp_right) };
+            const std::pair<std::size_t,bool> cmp
+            { search._upper ?
+                compare<true>(begin(pattern),end(pattern),search._pos,known) :
+                compare<false>(begin(pattern),end(pattern),search._pos,known) };
+            if (cmp.second)
+              {
+                search._right     = search._middle;
+                search._lcp_right = cmp.first;
+              }
+            else
+              {
+                search._left     = search._middle;
+                search._lcp_left = cmp.first;
+              }
+
+            if (!search._upper)
+              {
+                const std::size_t pat_len
+                { static_cast<std::size_t>(std::distance(begin(pattern),end(pattern))) };
+                if (cmp.first < pat_len && cmp.second)
+                  {
+                    search._upper_right     = search._middle;
+                    search._upper_lcp_right = cmp.first;
+                  }
+                else if (cmp.first == pat_len)
+                  {
+                    search._upper_left     = search._middle;
+                    search._upper_lcp_left = cmp.first;
+                  }
+              }
+          }
+
+        if (search._right - search._left <= 1)
+          {
+            if (search._upper)
+              return true;
+            /* The lower bound is found. Continue with the upper bound,
+             * between the last suffix found to match the pattern (or
+             * the one before the lower bound) and the first suffix found
+             * to be greater. */
+            search._lower = static_cast<Pos>(search._right);
+            search._upper = true;
+            if (search._upper_left > search._left)
+              {
+                search._left     = search._upper_left;
+                search._lcp_left = search._upper_lcp_left;
+              }
+            search._right     = search._upper_right;
+            search._lcp_right = search._upper_lcp_right;
+            if (search._right - search._left <= 1)
+              return true;
+          }
+
+        search._middle = search._left + (search._right - search._left) / 2;
+        search._loaded = false;
+        prefetch(&_sux_array[search._middle]);
+        return false;
+      }
+
+      void check_input() const
+      {
+        if (static_cast<std::size_t>(std::distance(std::begin(_text),std::end(_text)))
+            != _sux_array.size())
+          throw std::invalid_argument("The suffix array passed to sa_searcher does not "
+              "match the length of the text");
+      }
+
+      /**
+       * Fill Llcp and Rlcp for the middle elements of the search
+       * intervals contained in (left,right), and return the longest
+       * common prefix of the suffixes at `left` and `right`. The
+       * boundaries -1 and n stand for virtual suffixes that share no
+       * prefix with any other.
+       */
+      Pos make_boundary_lcps(const std::vector<Pos> &lcp, std::ptrdiff_t left, std::ptrdiff_t right)
+      {
+        if (right - left == 1)
+          return ((left < 0 || right == static_cast<std::ptrdiff_t>(lcp.size())) ? 0 : lcp[right]);
+        const std::ptrdiff_t middle
+        { left + (right - left) / 2 };
+        _llcp[middle] = make_boundary_lcps(lcp,left,middle);
+        _rlcp[middle] = make_boundary_lcps(lcp,middle,right);
+        return (_llcp[middle] < _rlcp[middle] ? _llcp[middle] : _rlcp[middle]);
+      }
+
+      /**
+       * Compare the pattern [from,to) to the suffix at `pos`, starting
+       * at offset `known`. The suffix is considered as truncated to the
+       * length of the pattern.
+       * @return The length of the common prefix, and whether the pattern
+       *   is smaller than or equal to the suffix (if `upper` is false) or
+       *   strictly smaller than it (if `upper` is true).
+       */
+      template <bool upper, typename PatIt>
+      std::pair<std::size_t,bool> compare(PatIt from, PatIt to, Pos pos, std::size_t known) const
+      {
+        const std::size_t pat_len
+        { static_cast<std::size_t>(std::distance(from,to)) };
+        const std::size_t limit
+        { std::min(pat_len,_sux_array.size() - pos) };
+        std::size_t matched
+        { known };
+        while (matched < limit && from[matched] == _text[pos + matched])
+          ++matched;
+        if (matched == pat_len)
+          return { matched , !upper };
+        if (matched == limit)
+          return { matched , false };
+        return { matched , (from[matched] < _text[pos + matched]) };
+      }
+
+      /**
+       * Binary search in the interval (left,right), where the suffix at
+       * `left` is known to be smaller than the pattern and to share
+       * `lcp_left` characters with it, and similarly for `right`. If
+       * `upper` is false, return the first suffix whose prefix is
+       * greater than or equal to the pattern; otherwise, the first
+       * whose prefix is greater. If `accelerated` is true, (left,right)
+       * must be an interval of the Llcp/Rlcp search tree.
+       */
+      template <bool upper, typename PatIt>
+      Pos bound(PatIt from, PatIt to,
+          std::ptrdiff_t left, std::size_t lcp_left, std::ptrdiff_t right, std::size_t lcp_right,
+          bool accelerated) const
+      {
+        while (right - left > 1)
+          {
+            const std::ptrdiff_t middle
+            { left + (right - left) / 2 };
+            std::size_t known
+            { lcp_left < lcp_right ? lcp_left : lcp_right };
+
+            if (accelerated)
+              {
+                /* Compare the middle suffix to the boundary that shares
+                 * the longer prefix with the pattern. */
+                const bool from_left
+                { lcp_left >= lcp_right };
+                const std::size_t boundary_lcp
+                { from_left ? _llcp[middle] : _rlcp[middle] };
+                const std::size_t pattern_lcp
+                { from_left ? lcp_left : lcp_right };
+                if (boundary_lcp != pattern_lcp)
+                  {
+                    /* The middle suffix agrees with the nearer boundary
+                     * beyond the point where the pattern deviates from
+                     * it, so it is on the same side of the pattern; or
+                     * it deviates earlier, in the opposite direction. */
+                    if ((boundary_lcp > pattern_lcp) == from_left)
+                      {
+                        left = middle;
+                        if (!from_left)
+                          lcp_left = boundary_lcp;
+                      }
+                    else
+                      {
+                        right = middle;
+                        if (from_left)
+                          lcp_right = boundary_lcp;
+                      }
+                    continue;
+                  }
+                known = pattern_lcp;
+              }
+
+            const std::pair<std::size_t,bool> cmp
+            { compare<upper>(from,to,_sux_array[middle],known) };
+            if (cmp.second)
+              {
+                right     = middle;
+                lcp_right = cmp.first;
+              }
+            else
+              {
+                left     = middle;
+                lcp_left = cmp.first;
+              }
+          }
+        return static_cast<Pos>(right);
+      }
+    };
+
+    /**
+     * Create a searcher for `text` with suffix array `sux_array`, using
+     * the mlr heuristic.
+     */
+    template <typename Text, typename Pos>
+    sa_searcher<Text,Pos> make_searcher(const Text &text, const std::vector<Pos> &sux_array)
+    { return sa_searcher<Text,Pos>(text,sux_array); }
+
+    /**
+     * Create a searcher for `text` that uses the LCP array `lcp` to
+     * accelerate the binary search.
+     */
+    template <typename Text, typename Pos>
+    sa_searcher<Text,Pos> make_searcher(
+        const Text &text, const std::vector<Pos> &sux_array, const std::vector<Pos> &lcp)
+    { return sa_searcher<Text,Pos>(text,sux_array,lcp); }
+
+    template <typename Text, typename Pos>
+    sa_searcher<Text,Pos> make_searcher(const Text &, std::vector<Pos> &&) = delete;
+    template <typename Text, typename Pos>
+    sa_searcher<Text,Pos> make_searcher(
+        const Text &, std::vector<Pos> &&, const std::vector<Pos> &) = delete;
+
+  } // search
+
+} // rlxalgo
+
+
+#endif /* SEARCH_HPP_ */
@@ -13,7 +13,8 @@
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
-#include <stack>
+#include <algorithm>
+#include <vector>
 
 #include "../util/more_type_traits.hpp"
 #include "../util/more_algorithm.hpp"
@@ -140,292 +141,369 @@ namespace rlxalgo {
       return vec;
     }
 
-    template <typename It>
-    void sort_s1_trigrams(It from, It to, rlxutil::parallel::portions &portions)
+    /**
+     * Derive the sorted order of the mod-0 suffixes from the sorted
+     * order of the mod-1 and mod-2 suffixes (`s12`, a sequence of text
+     * positions). The suffix at position i ≡ 0 (mod 3) is determined by
+     * its first character and the suffix at i+1, which is a mod-1
+     * suffix. Scanning `s12` and emitting i-1 for every i ≡ 1 (mod 3)
+     * therefore yields the mod-0 suffixes sorted by their second and
+     * following characters, and a single stable counting pass on the
+     * first character completes the order.
+     *
+     * `text` must be padded as described for `make_padded_suffix_array()`,
+     * and `alphabet` must cover all of its characters.
+     */
+    template <typename Pos, typename Char, typename AlphabetType>
+    sequence<Pos> make_s0_from_s12(
+        const sequence<Char> &text,
+        const sequence<Pos>  &s12,
+        std::size_t           num_s0,
+        const AlphabetType   &alphabet,
+        unsigned              threads)
     {
-      using rlx::AlphabetClass;
-      using namespace rlx::alphabet_tools;
-      using rlx::algotypes::elemtype;
-
-      typedef typename rlx::algotypes::ngram_it<It>::type it;
+      using std::make_tuple;
+      using rlxutil::parallel::tools::wait_for;
+      using rlxutil::parallel::tools::arg_generator;
 
-      /* For the first pass, based on lex array. */
-      auto succ_extractor = [](const elemtype<it> &trigram)
-      { return trigram._renamed_s1; };
+      typedef typename sequence<Pos>::const_iterator s12it;
 
-      /* For the second pass, based on the characters themselves. */
-      auto s1_extractor = [](const elemtype<it> &trigram)
-      { return trigram._ch; };
+      sequence<Pos> s0(num_s0);
+      if (num_s0 == 0)
+        return s0;
 
-      /* Temporary container. */
-      sequence<elemtype<it>> dest_vec(distance(from,to));
+      /* Emit the mod-0 positions in the order of their successors. Each
+       * thread counts the mod-1 positions in its portion first, so it
+       * knows where its part of the output begins. */
+      rlxutil::parallel::portions portions
+      { s12.begin() , s12.end() , threads };
 
-      /* First pass. */ // TODO. Use AlphabetClass::zero_range here. But: make_freq_table isn't ready for that yet.
-      rlx::paralgo::bucket_sort<AlphabetClass::sparse>(
-          from,to,dest_vec.begin(),succ_extractor,portions);
+      auto count_futs = portions.apply(s12.begin(),s12.end(),
+          [](s12it from, s12it to)
+          { return static_cast<std::size_t>(std::count_if(from,to,[](Pos pos) { return pos % 3 == 1; })); });
 
-      /* We re-use the portions object for the second pass, although it
-       * is applied to dest_vec this time. This is ok, because portion
-       * boundaries do not really matter for bucket sort. */
+      std::vector<std::size_t> offsets
+      { };
+      std::size_t total
+      { 0 };
+      for (auto &count_fut : count_futs)
+        {
+          offsets.push_back(total);
+          total += count_fut.get();
+        }
 
-      /* Second pass. */
-      rlx::paralgo::bucket_sort<AlphabetClass::sparse>(
-          dest_vec.begin(),dest_vec.end(),from,s1_extractor,portions);
+      auto emit_futs = portions.apply_dynargs(s12.begin(),s12.end(),
+          [&s0](s12it from, s12it to, std::size_t offset)
+          {
+            while (from != to)
+              {
+                if (*from % 3 == 1)
+                  s0[offset++] = *from - 1;
+                ++from;
+              }
+          },
+          arg_generator([&offsets](std::size_t portion) { return make_tuple(offsets[portion]); }));
+      wait_for(emit_futs);
+
+      /* One stable pass on the first character. */
+      sequence<Pos> temp(num_s0);
+      rlxutil::parallel::portions s0_portions
+      { s0.begin() , s0.end() , threads };
+      sux::TrigramSorter<Char,Pos>::lsd_pass(s0,temp,
+          [&text](const Pos &pos) { return text[pos]; },
+          alphabet,s0_portions);
+
+      return s0;
     }
 
-    template <typename It>
-    void sort_s1_trigrams(It from, It to, unsigned threads = 4)
-    {
-      rlxutil::parallel::portions portions
-      { from , to , threads };
-      sort_s1_trigrams(from,to,portions);
-    }
+    /**
+     * Memory layout used by the final merge of the mod-0 suffixes with
+     * the mod-1 and mod-2 suffixes.
+     *
+     *  - `direct`: The merge works on plain text positions and looks up
+     *    characters and ranks in the text and in the rank array for each
+     *    comparison. These lookups are at random positions and depend on
+     *    the outcome of the previous comparison, so most of them miss the
+     *    cache.
+     *  - `colocated`: A preparation pass first attaches the characters
+     *    and ranks needed by the comparisons to each element. The lookups
+     *    of that pass are independent of each other, and the merge itself
+     *    then reads both sequences sequentially. This uses more memory
+     *    during the merge.
+     */
+    enum class MergeLayout { direct, colocated };
 
-    template <typename It, typename Extractor = rlx::id<rlxtype::deref<It>> >
-    struct inserter
+    /**
+     * Mod-1 or mod-2 suffix, prepared for the `colocated` merge.
+     */
+    template <typename Char, typename Pos>
+    struct S12MergeKey
     {
-      inserter(It it):_it(it),_ex()
-      { }
-      template <typename Ex>
-      inserter(It it, Ex &&ex):_it(it),_ex(ex)
-      { }
-      inserter &operator*()
-      { return *this; }
-      inserter &operator++()
-      { return *this; }
-      inserter &operator++(int)
-      { return *this; }
-      inserter &operator=(const rlxtype::deref<It> &val)
-      { *(_it++) = _ex(val); return *this; }
-      inserter &operator=(rlxtype::deref<It> &&val)
-      { *(_it++) = _ex(std::move(val)); return *this; }
-    private:
-      It        _it;  // internal iterator
-      Extractor _ex;  // extractor function
+      Pos  _pos;   // Position of the suffix
+      Pos  _rank;  // Rank of the suffix at _pos+1 (mod 1) or _pos+2 (mod 2)
+      Char _ch[2]; // First two characters
     };
 
-
-    template <typename Pos, typename It>
-    sequence<Pos> make_suffix_array(It from, It to, unsigned threads = 4)
+    /**
+     * Mod-0 suffix, prepared for the `colocated` merge.
+     */
+    template <typename Char, typename Pos>
+    struct S0MergeKey
     {
-      using std::numeric_limits;
-      using std::is_integral;
-      using std::uintmax_t;
-      using std::distance;
+      Pos  _pos;   // Position of the suffix
+      Pos  _rank1; // Rank of the suffix at _pos+1
+      Pos  _rank2; // Rank of the suffix at _pos+2
+      Char _ch[2]; // First two characters
+    };
 
-      using namespace rlx::algotypes;
-      typedef char_it<It> inp;
+    /**
+     * Merge the sorted mod-1/mod-2 suffixes `s12` (ignoring the first
+     * `skip` of them) and the sorted mod-0 suffixes `s0` into `dest`.
+     * `rank_of(pos)` returns the rank of the mod-1 or mod-2 suffix at
+     * `pos`.
+     */
+    template <typename Pos, typename Char, typename RankOf>
+    void merge_s12_s0(
+        std::integral_constant<MergeLayout,MergeLayout::direct>,
+        const sequence<Char> &text, sequence<Pos> s12, std::size_t skip, sequence<Pos> s0,
+        RankOf rank_of, sequence<Pos> &dest, unsigned threads)
+    {
+      rlx::paralgo::merge_sorted(
+          s12.begin() + skip,s12.end(),s0.begin(),s0.end(),dest.begin(),
+          [&text,&rank_of](const Pos &lhs, const Pos &rhs)
+          {
+            if (text[lhs] != text[rhs])
+              return (text[lhs] < text[rhs]);
+            if (lhs % 3 == 1)
+              return (rank_of(lhs + 1) < rank_of(rhs + 1));
+            if (text[lhs + 1] != text[rhs + 1])
+              return (text[lhs + 1] < text[rhs + 1]);
+            return (rank_of(lhs + 2) < rank_of(rhs + 2));
+          },
+          threads);
+    }
 
-      static_assert(is_integral<Pos>::value,
-          "The position type used for make_suffix_array must be an integral type.");
-      if (static_cast<uintmax_t>(numeric_limits<Pos>::max())
-          > static_cast<uintmax_t>(distance(from,to)))
-          throw std::out_of_range("Attempt to use a position type with make_suffix_array that "
-              "is not large enough for the given input string");
+    template <typename Pos, typename Char, typename RankOf>
+    void merge_s12_s0(
+        std::integral_constant<MergeLayout,MergeLayout::colocated>,
+        const sequence<Char> &text, sequence<Pos> s12, std::size_t skip, sequence<Pos> s0,
+        RankOf rank_of, sequence<Pos> &dest, unsigned threads)
+    {
+      using rlxutil::parallel::tools::wait_for;
+
+      typedef S12MergeKey<Char,Pos> s12_key_type;
+      typedef S0MergeKey<Char,Pos>  s0_key_type;
+      typedef typename sequence<s12_key_type>::iterator s12_key_it;
+      typedef typename sequence<s0_key_type>::iterator  s0_key_it;
+
+      /* Preparation: gather characters and ranks. */
+      sequence<s12_key_type> s12_keys(s12.size() - skip);
+      rlxutil::parallel::portions s12_portions
+      { s12_keys.begin() , s12_keys.end() , threads };
+      auto s12_futs = s12_portions.apply(s12_keys.begin(),s12_keys.end(),
+          [skip,&text,&s12,&rank_of](s12_key_it from, s12_key_it to, s12_key_it beg)
+          {
+            auto pos_it = s12.cbegin() + skip + std::distance(beg,from);
+            while (from != to)
+              {
+                const Pos pos = *pos_it++;
+                *from++ = s12_key_type
+                    { pos , rank_of(pos % 3 == 1 ? pos + 1 : pos + 2) , { text[pos] , text[pos + 1] } };
+              }
+          },s12_keys.begin());
+
+      sequence<s0_key_type> s0_keys(s0.size());
+      rlxutil::parallel::portions s0_portions
+      { s0_keys.begin() , s0_keys.end() , threads };
+      auto s0_futs = s0_portions.apply(s0_keys.begin(),s0_keys.end(),
+          [&text,&s0,&rank_of](s0_key_it from, s0_key_it to, s0_key_it beg)
+          {
+            auto pos_it = s0.cbegin() + std::distance(beg,from);
+            while (from != to)
+              {
+                const Pos pos = *pos_it++;
+                *from++ = s0_key_type
+                    { pos , rank_of(pos + 1) , rank_of(pos + 2) , { text[pos] , text[pos + 1] } };
+              }
+          },s0_keys.begin());
+
+      wait_for(s12_futs);
+      wait_for(s0_futs);
+      s12 = sequence<Pos>();
+      s0  = sequence<Pos>();
+
+      /* Sequential merge of the prepared keys. */
+      rlx::paralgo::merge_sorted(
+          s12_keys.begin(),s12_keys.end(),s0_keys.begin(),s0_keys.end(),dest.begin(),
+          [](const s12_key_type &lhs, const s0_key_type &rhs)
+          {
+            if (lhs._ch[0] != rhs._ch[0])
+              return (lhs._ch[0] < rhs._ch[0]);
+            if (lhs._pos % 3 == 1)
+              return (lhs._rank < rhs._rank1);
+            if (lhs._ch[1] != rhs._ch[1])
+              return (lhs._ch[1] < rhs._ch[1]);
+            return (lhs._rank < rhs._rank2);
+          },
+          threads,
+          [](const s12_key_type &key) { return key._pos; },
+          [](const s0_key_type &key) { return key._pos; });
+    }
 
+    /**
+     * Compute the suffix array of the first `length` characters of
+     * `text`, using the skew (DC3) algorithm. The characters must be in
+     * the range [1,highest], and `text` must be followed by at least
+     * three 0-characters that serve as sentinels.
+     */
+    template <typename Pos, MergeLayout layout, typename Char>
+    sequence<Pos> make_padded_suffix_array(
+        const sequence<Char> &text, std::size_t length, std::size_t highest, unsigned threads)
+    {
+      using std::size_t;
+      using std::move;
       using rlx::AlphabetClass;
       using rlx::Alphabet;
-      using lex       = lexicographical_renaming;
-      using recursion = lex::recursion;
+      using rlxutil::parallel::tools::wait_for;
+      using namespace sux::trigram_tools;
+      using lex = lexicographical_renaming;
 
-      /* Extract 2,3-trigrams. */
-      auto trigrams = sux::extract_23trigrams<Pos>(from,to);
-      /* Sort them. */
-      Alphabet<AlphabetClass::sparse,chtype<inp>,Pos> alphabet
-      { };
+      typedef typename sequence<Pos>::iterator posit;
+
+      if (length == 0)
+        return { };
+
+      /* Number of mod-0, mod-1 and mod-2 positions. If the length is
+       * 1 (mod 3), the 2,3-trigrams include a dummy mod-1 trigram at
+       * position `length`, consisting of sentinels only. It ensures
+       * that the names of mod-1 suffixes are never compared across the
+       * boundary to the mod-2 names during recursion. */
+      const size_t n0  { (length + 2) / 3 };
+      const size_t n2  { length / 3 };
+      const size_t n02 { n0 + n2 };
+
+      const Alphabet<AlphabetClass::zero_range,Char,Pos> alphabet
+      { highest + 1 };
+
+      /* Sort the 2,3-trigrams and name them. */
+      auto trigrams = sux::extract_23trigrams<Pos>(
+          text.begin(),text.begin() + (length + (length % 3 == 1 ? 3 : 2)),threads);
       sux::sort_23trigrams(trigrams,alphabet,threads);
-      /* Generate an integer alphabet for them according to
-       * their sorting order. */
-      auto new_names = rename_lexicographically(
-          from,trigrams,center_of(from,to),threads);
+      auto renamed = rename_lexicographically(text.begin(),trigrams,n0,threads);
 
-      using std::size_t;
-      using std::get;
-      using std::stack;
-      using std::pair;
-      using std::move;
-      using sux::triget1;
-      using sux::triget2;
-      using sux::triget3;
-      using rlxtype::itertype;
-      using rlx::seqtools::size;
-      using namespace sux::trigram_tools;
+      /* Sorted mod-1 and mod-2 positions, and the rank of each of them,
+       * indexed like the renamed string. Ranks start at 1. */
+      sequence<Pos> s12(n02);
+      sequence<Pos> ranks = lex::move_newstring_from(renamed);
 
-      /* We'll move the end result into this object: */
-      sequence<Pos> result;
+      rlxutil::parallel::portions portions
+      { s12.begin() , s12.end() , threads };
 
-      if (lex::is<recursion::needed>(new_names))
+      if (lex::is<lex::recursion::needed>(renamed))
         {
-          auto renamed_string =
-              lex::move_newstring_from(new_names);
-          auto alphabet_size  =
-              lex::alphsize(new_names);
-          auto renamed_trigrams =
-              sux::extract_23trigrams<Pos>(renamed_string.begin(),renamed_string.end());
-
-          Alphabet<AlphabetClass::zero_range,Pos,Pos> alphabet
-          { alphabet_size };
-
-          sux::sort_23trigrams(renamed_trigrams,alphabet,threads);
-
-          stack<pair<noref<decltype(renamed_string)>,noref<decltype(renamed_trigrams)>>>
-          workpile
-          { };
-
-          workpile.emplace(move(renamed_string),move(renamed_trigrams));
-          while (!workpile.empty())
-            {
-              auto &rec_text            = get<0>(workpile.top());
-              auto center               = center_of(rec_text);
-              auto &rec_sorted_trigrams = get<1>(workpile.top());
-              auto rec_renamed = rename_lexicographically(
-                  begin(rec_text),rec_sorted_trigrams,center,threads);
-              if (lex::is<recursion::needed>(rec_renamed))
-                {
-                  /* Recursion. */
-                  auto new_rec_text = lex::move_newstring_from(rec_renamed);
-                  auto rec_alphsize = lex::alphsize(rec_renamed);
-                  auto rec_trigrams =
-                      sux::extract_23trigrams<Pos>(new_rec_text.begin(),new_rec_text.end());
-                  Alphabet<AlphabetClass::zero_range,Pos,Pos> rec_alphabet
-                  { rec_alphsize };
-                  sux::sort_23trigrams(rec_trigrams,rec_alphabet,threads);
-                  workpile.emplace(move(new_rec_text),move(rec_trigrams));
-                }
-              else
-                {
-                  auto rec_new_names  = lex::move_newstring_from(rec_renamed);
-                  /* End of recursion. Wind up the workpile. */
-                  for (;;)
-                    {
-                      auto s1 =
-                          make_s1_trigrams<sux::TGImpl::structure>(
-                              begin(rec_text),end(rec_text),begin(rec_new_names),end(rec_new_names),threads);
-                      /* Sort S1. */
-                      sort_s1_trigrams(begin(s1),end(s1),threads);
-                      /* Merge S1 and S12 into the suffix array for rec_text. */
-                      sequence<Pos> sux_array
-                      ((size_t)distance(begin(rec_text),end(rec_text)));
-
-                      auto rec_s23 = move(get<1>(workpile.top()));
-                      typedef rlxtype::elemtype<decltype(rec_s23)> s23_elem_type;
-                      typedef rlxtype::elemtype<decltype(s1)>      s1_elem_type;
-                      /* Center of the renamed lexicographical names array. */
-                      const Pos center = rec_new_names.size() / 2 + (rec_new_names.size() % 2 == 1 ? 1 : 0);
-                      /* Merge the S1 and the S23 array. */
-                      /*  TODO. CONTINUE HERE. Use an 'inserter' instead of
-                       * begin(sux_array). */
-                      rlx::seqalgo::merge_sorted(
-                          begin(rec_s23),end(rec_s23),begin(s1),end(s1),begin(sux_array),
-                          [center,&rec_new_names,&rec_text]
-                           (const s23_elem_type &lhs, const s1_elem_type &rhs)
-                          {
-                            if (triget1(lhs) < rhs._ch)
-                              return true;
-                            if (triget1(lhs) == rhs._ch) {
-                              if (pos_of(lhs) % 3 == 1)
-                                {
-                                  Pos lhs_lex = rec_new_names[center + pos_of(lhs)/3];
-                                  Pos rhs_lex = rhs._renamed_s1;
-                                  return (lhs_lex < rhs_lex);
-                                }
-                              else
-                                {
-                                  Pos lhs_ch = triget2(lhs);
-                                  Pos rhs_ch = rec_text[rhs._pos + 1];
-                                  if (lhs_ch < rhs_ch)
-                                    return true;
-                                  Pos lhs_lex = rec_new_names[pos_of(lhs)/3 + 1];
-                                  Pos rhs_lex = rec_new_names[center + rhs._pos/3];
-                                  return (lhs_lex < rhs_lex);
-                                }
-                            }
-                          });
-
-                      /* Take the current work item off the pile; it's done. */
-                      workpile.pop();
-
-                      if (!workpile.empty())
-                        {
-                          /* We re-use the sequence `rec_lex` to store the inversion
-                           * of the suffix array we've just computed. */
-                          rec_new_names.resize(size(sux_array));
-
-                          rlxutil::parallel::portions portions
-                          { begin(sux_array) , end(sux_array) , threads };
-
-                          typedef itertype<decltype(sux_array)> suxit;
-                          portions.apply(begin(sux_array),end(sux_array),
-                              [&rec_new_names](suxit suxfrom, suxit suxto, suxit suxbeg)
-                              {
-                                while (suxfrom != suxto) {
-                                  rec_new_names[*suxfrom] = distance(suxbeg,suxfrom);
-                                  ++suxfrom;
-                                }
-                              },begin(sux_array));
-                        }
-                      else
-                        {
-                          result = move(sux_array);
-                          break;
-                        }
-                    }
-                }
-            }
+          const size_t rec_highest
+          { lex::alphsize(renamed) };
+          trigrams = decltype(trigrams)();
+
+          /* The renamed string becomes the text of the recursion. */
+          for (auto &name : ranks)
+            ++name;
+          ranks.resize(n02 + 3,0);
+          sequence<Pos> rec_sa =
+              make_padded_suffix_array<Pos,layout,Pos>(ranks,n02,rec_highest,threads);
+
+          auto futs = portions.apply(rec_sa.begin(),rec_sa.end(),
+              [n0,&ranks,&s12](posit from, posit to, posit beg)
+              {
+                Pos rank = static_cast<Pos>(std::distance(beg,from));
+                while (from != to)
+                  {
+                    const Pos index = *from++;
+                    ranks[index]  = ++rank;
+                    s12[rank - 1] = (index < n0 ? 3 * index + 1 : 3 * (index - n0) + 2);
+                  }
+              },rec_sa.begin());
+          wait_for(futs);
         }
       else
         {
-          /* This is the case when the very first pass of trigram sorting gave
-           * us a perfect suffix array for S23 with no duplicate trigrams. */
-
-          /* Use the lexicographically renamed string as inverse of S23. */
-          auto inv_sux = lex::move_newstring_from(new_names);
-          /* We make an S1 string. */
-          auto s1 =
-              make_s1_trigrams<sux::TGImpl::structure>(
-                  from,to,begin(inv_sux),end(inv_sux),threads);
-          /* Sort S1. */
-          sort_s1_trigrams(begin(s1),end(s1),threads);
-          /* Merge S1 and S12 into the suffix array for rec_text. */
-          sequence<Pos> sux_array
-          ((size_t)distance(from,to));
-
-          typedef rlxtype::elemtype<decltype(trigrams)> s23_elem_type;
-          typedef rlxtype::elemtype<decltype(s1)>       s1_elem_type;
-
-          /* Center of the renamed lexicographical names array. */
-          const Pos center = inv_sux.size() / 2 + (inv_sux.size() % 2 == 1 ? 1 : 0);
-          /* Merge the S1 and the S23 array. */
-          rlx::seqalgo::merge_sorted(
-              begin(trigrams),end(trigrams),begin(s1),end(s1),begin(sux_array),
-              [center,&inv_sux,&trigrams](const s23_elem_type &lhs, const s1_elem_type &rhs)
+          /* All names are unique, so the sorted trigrams are the sorted
+           * suffixes, and the names are their ranks. */
+          auto futs = portions.apply(s12.begin(),s12.end(),
+              [&trigrams,&ranks,&s12,&text](posit from, posit to, posit beg)
               {
-                if (triget1(lhs) < rhs._ch)
-                  return true;
-                if (triget1(lhs) == rhs._ch) {
-                  if (pos_of(lhs) % 3 == 1)
-                    {
-                      Pos lhs_lex = inv_sux[center + pos_of(lhs)/3];
-                      Pos rhs_lex = rhs._renamed_s1;
-                      return (lhs_lex < rhs_lex);
-                    }
-                  else
-                    {
-                      Pos lhs_ch = triget2(lhs);
-                      Pos rhs_ch = trigrams[rhs._pos + 1];
-                      if (lhs_ch < rhs_ch)
-                        return true;
-                      Pos lhs_lex = inv_sux[pos_of(lhs)/3 + 1];
-                      Pos rhs_lex = inv_sux[center + rhs._pos/3];
-                      return (lhs_lex < rhs_lex);
-                    }
-                }
-              });
-
-          result = move(sux_array);
+                const size_t first = std::distance(beg,from);
+                const size_t last  = std::distance(beg,to);
+                for (size_t index = first ; index < last ; ++index)
+                  {
+                    s12[index] = pos_of(text.begin(),trigrams[index]);
+                    ++ranks[index];
+                  }
+              },s12.begin());
+          wait_for(futs);
         }
+      trigrams = decltype(trigrams)();
+
+      /* Rank of the suffix at a mod-1 or mod-2 position. The empty
+       * suffix (and anything beyond) is ranked 0. */
+      auto rank_of = [length,n0,&ranks](size_t pos) -> Pos
+      {
+        if (pos >= length)
+          return 0;
+        return (pos % 3 == 1 ? ranks[pos / 3] : ranks[n0 + pos / 3]);
+      };
+
+      sequence<Pos> s0 = make_s0_from_s12<Pos>(text,s12,n0,alphabet,threads);
+
+      /* Merge. The dummy trigram, if any, has the smallest rank and is
+       * skipped. */
+      sequence<Pos> sux_array(length);
+      merge_s12_s0(std::integral_constant<MergeLayout,layout>(),
+          text,move(s12),(length % 3 == 1 ? 1 : 0),move(s0),rank_of,sux_array,threads);
+
+      return sux_array;
+    }
+
+    /**
+     * Calls `make_padded_suffix_array()` for texts of any character
+     * type (see `rlx::alphabet_tools::with_sentinel_text()`).
+     */
+    template <typename Pos, MergeLayout layout>
+    struct padded_builder
+    {
+      unsigned _threads;
+
+      template <typename Char>
+      sequence<Pos> operator()(const sequence<Char> &text, std::size_t length, std::size_t highest) const
+      { return make_padded_suffix_array<Pos,layout>(text,length,highest,_threads); }
+    };
+
+    /**
+     * Compute the suffix array of the text [from,to), using the skew
+     * (DC3) algorithm with `threads` parallel threads. `layout` selects
+     * the memory layout of the final merge at each recursion level.
+     */
+    template <typename Pos, MergeLayout layout = MergeLayout::colocated, typename It>
+    sequence<Pos> make_suffix_array(It from, It to, unsigned threads = 4)
+    {
+      using std::numeric_limits;
+      using std::is_integral;
+      using std::uintmax_t;
+      using std::distance;
+
+      static_assert(is_integral<Pos>::value,
+          "The position type used for make_suffix_array must be an integral type.");
+      if (static_cast<uintmax_t>(numeric_limits<Pos>::max())
+          < static_cast<uintmax_t>(distance(from,to)) + 3)
+          throw std::out_of_range("Attempt to use a position type with make_suffix_array that "
+              "is not large enough for the given input string");
 
-      return result;
+      /* Replace each character by its rank among the characters that
+       * actually occur, so all passes over the input use a zero-range
+       * alphabet of size sigma rather than the full character type. */
+      return rlx::alphabet_tools::with_sentinel_text<Pos>(from,to,3,threads,
+          padded_builder<Pos,layout>
+          { threads });
     }
 
 
@@ -0,0 +1,50 @@
+/*
+ * suffix_array.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef SUFFIX_ARRAY_HPP_
+#define SUFFIX_ARRAY_HPP_
+
+#include <type_traits>
+#include <vector>
+
+#include "skew.hpp"
+#include "sais.hpp"
+
+namespace rlxalgo {
+
+  /**
+   * Suffix array construction algorithms:
+   *
+   *  - `skew`: The difference-cover algorithm of Kärkkäinen and Sanders
+   *    (see skew.hpp). Most of its passes run in parallel.
+   *  - `sais`: Induced sorting (see sais.hpp). Mostly sequential, but
+   *    needs much less working memory.
+   */
+  enum class SAEngine { skew, sais };
+
+  template <typename Pos, typename It>
+  std::vector<Pos> make_suffix_array(
+      std::integral_constant<SAEngine,SAEngine::skew>, It from, It to, unsigned threads)
+  { return skew::make_suffix_array<Pos>(from,to,threads); }
+
+  template <typename Pos, typename It>
+  std::vector<Pos> make_suffix_array(
+      std::integral_constant<SAEngine,SAEngine::sais>, It from, It to, unsigned threads)
+  { return sais::make_suffix_array<Pos>(from,to,threads); }
+
+  /**
+   * Compute the suffix array of the text [from,to), using the
+   * construction algorithm selected by `engine`.
+   */
+  template <typename Pos, SAEngine engine = SAEngine::skew, typename It>
+  std::vector<Pos> make_suffix_array(It from, It to, unsigned threads = 4)
+  { return make_suffix_array<Pos>(std::integral_constant<SAEngine,engine>(),from,to,threads); }
+
+}
+
+
+#endif /* SUFFIX_ARRAY_HPP_ */
@@ -0,0 +1,120 @@
+/*
+ * bitvector_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BitvectorTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <glog/logging.h>
+
+#include "../bitvector.hpp"
+
+using rlxalgo::succinct::bitvector;
+
+/**
+ * Compare rank1, rank0, select1 and select0 at every position with the
+ * values computed by a scan of the bits.
+ */
+void check_bitvector(const bitvector &bits, const std::vector<bool> &expected)
+{
+  BOOST_CHECK(bits.size() == expected.size());
+  bool correct
+  { true };
+  std::size_t ones
+  { 0 };
+  for (std::size_t pos = 0 ; pos < expected.size() ; ++pos)
+    {
+      correct = correct
+          && bits[pos] == expected[pos]
+          && bits.rank1(pos) == ones
+          && bits.rank0(pos) == pos - ones;
+      if (expected[pos])
+        correct = correct && bits.select1(ones++) == pos;
+      else
+        correct = correct && bits.select0(pos - ones) == pos;
+    }
+  correct = correct && bits.rank1(expected.size()) == ones && bits.ones() == ones;
+  BOOST_CHECK_MESSAGE(correct,"Incorrect rank or select for bit vector of size " << expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(sux_bitvector_test_word)
+{
+  using rlxalgo::succinct::tools::select_in_word;
+
+  std::mt19937_64 gen
+  { 1 };
+  bool correct
+  { true };
+  for (unsigned i = 0 ; i < 10000 ; ++i)
+    {
+      const std::uint64_t word = gen() & gen();
+      unsigned rank
+      { 0 };
+      for (unsigned bit = 0 ; bit < 64 ; ++bit)
+        if ((word >> bit) & 1)
+          correct = correct && select_in_word(word,rank++) == bit;
+    }
+  BOOST_CHECK(correct);
+  BOOST_CHECK(select_in_word(~std::uint64_t(0),63) == 63);
+  BOOST_CHECK(select_in_word(std::uint64_t(1) << 63,0) == 63);
+}
+
+BOOST_AUTO_TEST_CASE(sux_bitvector_test1)
+{
+  bitvector bits(10);
+  bits.set(1);
+  bits.set(4);
+  bits.set(5);
+  bits.set(9);
+  bits.set(5,false);
+  bits.build_index(1);
+  BOOST_CHECK(bits.ones() == 3);
+  BOOST_CHECK(bits.rank1(0) == 0);
+  BOOST_CHECK(bits.rank1(2) == 1);
+  BOOST_CHECK(bits.rank1(10) == 3);
+  BOOST_CHECK(bits.rank0(10) == 7);
+  BOOST_CHECK(bits.select1(1) == 4);
+  BOOST_CHECK(bits.select1(2) == 9);
+  BOOST_CHECK(bits.select0(0) == 0);
+  BOOST_CHECK(bits.select0(2) == 3);
+
+  bitvector empty(0);
+  empty.build_index(1);
+  BOOST_CHECK(empty.rank1(0) == 0);
+  BOOST_CHECK(empty.ones() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sux_bitvector_test_random)
+{
+  std::mt19937 gen
+  { 3 };
+  for (double density : { 0.0 , 0.0005 , 0.1 , 0.5 , 0.99 , 1.0 })
+    for (std::size_t size : { 63 , 64 , 511 , 512 , 513 , 100000 , 1000000 })
+      {
+        std::bernoulli_distribution dist
+        { density };
+        std::vector<bool> expected(size);
+        for (std::size_t pos = 0 ; pos < size ; ++pos)
+          expected[pos] = dist(gen);
+
+        /* Built in parallel from a function, and sequentially by
+         * setting single bits. */
+        const bitvector parallel_bits
+        { size , [&expected](std::size_t pos) { return bool(expected[pos]); } , 4 };
+        check_bitvector(parallel_bits,expected);
+
+        bitvector bits(size);
+        for (std::size_t pos = 0 ; pos < size ; ++pos)
+          if (expected[pos])
+            bits.set(pos);
+        bits.build_index(1);
+        check_bitvector(bits,expected);
+      }
+}
@@ -0,0 +1,108 @@
+/*
+ * bwt_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BwtTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <random>
+#include <iterator>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../bwt.hpp"
+
+typedef unsigned int pos_type;
+
+/**
+ * Recover the text from its BWT by following the LF mapping from the
+ * primary index.
+ */
+std::string invert_bwt(const std::string &bwt, std::size_t primary)
+{
+  std::vector<std::size_t> counts(257,0);
+  for (std::size_t row = 0 ; row < bwt.size() ; ++row)
+    if (row != primary)
+      ++counts[static_cast<unsigned char>(bwt[row]) + 1];
+  /* The sentinel sorts first. */
+  counts[0] = 1;
+  for (std::size_t c = 1 ; c < counts.size() ; ++c)
+    counts[c] += counts[c-1];
+  std::vector<std::size_t> lf(bwt.size());
+  std::vector<std::size_t> seen(256,0);
+  for (std::size_t row = 0 ; row < bwt.size() ; ++row)
+    if (row == primary)
+      lf[row] = 0;
+    else
+      {
+        const unsigned char c = static_cast<unsigned char>(bwt[row]);
+        lf[row] = counts[c] + seen[c]++;
+      }
+
+  std::string text(bwt.size() - 1,' ');
+  std::size_t row
+  { 0 };
+  for (std::size_t i = text.size() ; i-- > 0 ; )
+    {
+      text[i] = bwt[row];
+      row = lf[row];
+    }
+  return text;
+}
+
+BOOST_AUTO_TEST_CASE(sux_bwt_test1)
+{
+  const std::string text
+  { "banana" };
+  std::string bwt;
+  const pos_type primary
+  { rlxalgo::bwt::make_bwt<pos_type>(text.begin(),text.end(),std::back_inserter(bwt),1,'$') };
+  BOOST_CHECK(bwt == "annb$aa");
+  BOOST_CHECK(primary == 4);
+
+  const std::string empty
+  { };
+  bwt.clear();
+  BOOST_CHECK(rlxalgo::bwt::make_bwt<pos_type>(empty.begin(),empty.end(),std::back_inserter(bwt),1,'$') == 0);
+  BOOST_CHECK(bwt == "$");
+}
+
+BOOST_AUTO_TEST_CASE(sux_bwt_test_invert)
+{
+  std::mt19937 gen
+  { 3 };
+  std::uniform_int_distribution<int> dist
+  { 0 , 3 };
+  std::vector<std::string> texts
+  { "a" , "abracadabra" , std::string(1000,'x') };
+  /* Longer than one block of rows. */
+  std::string random_text;
+  for (std::size_t i = 0 ; i < 1500000 ; ++i)
+    random_text.push_back('a' + dist(gen));
+  texts.push_back(random_text);
+
+  for (const auto &text : texts)
+    {
+      auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),2);
+
+      /* Streamed, as if to a file. */
+      std::ostringstream stream;
+      const pos_type primary
+      { rlxalgo::bwt::from_suffix_array(text.begin(),text.end(),sux_array,
+          std::ostreambuf_iterator<char>(stream),4) };
+      const std::string bwt
+      { stream.str() };
+      BOOST_CHECK(bwt.size() == text.size() + 1);
+      BOOST_CHECK(sux_array[primary - 1] == 0);
+      BOOST_CHECK_MESSAGE(invert_bwt(bwt,primary) == text,
+          "BWT not invertible for text of length " << text.size());
+    }
+}
@@ -0,0 +1,151 @@
+/*
+ * fm_index_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE FmIndexTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../search.hpp"
+#include "../fm_index.hpp"
+
+typedef unsigned int pos_type;
+
+/**
+ * Compare the backward search of the FM-index with the binary search
+ * of the suffix array for every pattern, and check the LF mapping of
+ * every row against the suffix array.
+ */
+template <typename Text>
+void check_fm_index(const Text &text, const std::vector<Text> &patterns)
+{
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(begin(text),end(text),2);
+  auto searcher  = rlxalgo::search::make_searcher(text,sux_array);
+  const rlxalgo::fm::fm_index<typename Text::value_type,pos_type> index
+  { begin(text) , end(text) , sux_array , 3 };
+
+  /* The position of an empty interval is not specified. */
+  for (const auto &pattern : patterns)
+    {
+      const auto expected = searcher.find(pattern);
+      const auto actual   = index.find(pattern);
+      BOOST_CHECK_MESSAGE(expected.empty() ? actual.empty() : actual == expected,
+          "Incorrect interval for pattern of length " << pattern.size()
+          << " in text of length " << text.size());
+    }
+
+  /* Row r holds the suffix sux_array[r-1]; row 0 the sentinel. */
+  std::vector<pos_type> row_of(text.size() + 1);
+  row_of[text.size()] = 0;
+  for (std::size_t i = 0 ; i < sux_array.size() ; ++i)
+    row_of[sux_array[i]] = static_cast<pos_type>(i + 1);
+  bool lf_correct
+  { index.lf(0) == row_of[text.size() - 1] };
+  for (std::size_t i = 0 ; i < sux_array.size() ; ++i)
+    lf_correct = lf_correct
+      && index.lf(static_cast<pos_type>(i + 1)) == (sux_array[i] == 0 ? 0 : row_of[sux_array[i] - 1]);
+  BOOST_CHECK_MESSAGE(lf_correct,"Incorrect LF mapping for text of length " << text.size());
+}
+
+/**
+ * Patterns taken from the text, and the same patterns with their last
+ * character changed.
+ */
+template <typename Text, typename Gen>
+std::vector<Text> make_patterns(const Text &text, Gen &gen, std::size_t num, std::size_t max_length)
+{
+  std::vector<Text> patterns;
+  std::uniform_int_distribution<std::size_t> pos_dist
+  { 0 , text.size() - 1 };
+  std::uniform_int_distribution<std::size_t> len_dist
+  { 1 , max_length };
+  for (std::size_t i = 0 ; i < num ; ++i)
+    {
+      const std::size_t pos = pos_dist(gen);
+      const std::size_t len = std::min(len_dist(gen),text.size() - pos);
+      Text pattern(begin(text) + pos,begin(text) + pos + len);
+      patterns.push_back(pattern);
+      pattern.back() = text[pos_dist(gen)];
+      patterns.push_back(pattern);
+    }
+  return patterns;
+}
+
+BOOST_AUTO_TEST_CASE(sux_fm_index_test1)
+{
+  const std::string text
+  { "mississippi" };
+  auto index = rlxalgo::fm::make_fm_index<pos_type>(text.begin(),text.end(),1);
+
+  /* Suffix array: 10 7 4 1 0 9 8 6 3 5 2 */
+  BOOST_CHECK(index.size() == 11);
+  BOOST_CHECK(index.sigma() == 4);
+  BOOST_CHECK((index.find(std::string("ssi")) == rlxalgo::search::sa_interval<pos_type> { 9 , 11 }));
+  BOOST_CHECK((index.find(std::string("i")) == rlxalgo::search::sa_interval<pos_type> { 0 , 4 }));
+  BOOST_CHECK((index.find(std::string("")) == rlxalgo::search::sa_interval<pos_type> { 0 , 11 }));
+  BOOST_CHECK(index.count(std::string("issi")) == 2);
+  BOOST_CHECK(index.count(std::string("mississippi")) == 1);
+  BOOST_CHECK(index.count(std::string("mississippis")) == 0);
+  BOOST_CHECK(index.count(std::string("a")) == 0);
+  BOOST_CHECK(index.count(std::string("ssz")) == 0);
+
+  const std::string empty
+  { };
+  auto empty_index = rlxalgo::fm::make_fm_index<pos_type>(empty.begin(),empty.end(),1);
+  BOOST_CHECK(empty_index.count(std::string("a")) == 0);
+  BOOST_CHECK(empty_index.count(empty) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sux_fm_index_test_random)
+{
+  std::mt19937 gen
+  { 5 };
+  std::uniform_int_distribution<int> dist
+  { 0 , 3 };
+
+  /* Lengths around the block and superblock boundaries of the rank
+   * directory, and a text of several superblocks. */
+  for (std::size_t length : { 255 , 256 , 65535 , 65536 , 300000 })
+    {
+      std::string text;
+      for (std::size_t i = 0 ; i < length ; ++i)
+        text.push_back('a' + dist(gen));
+      check_fm_index(text,make_patterns(text,gen,500,20));
+    }
+
+  /* All byte values, including negative chars. */
+  std::uniform_int_distribution<int> byte_dist
+  { -128 , 127 };
+  std::string bytes;
+  for (std::size_t i = 0 ; i < 100000 ; ++i)
+    bytes.push_back(static_cast<char>(byte_dist(gen)));
+  check_fm_index(bytes,make_patterns(bytes,gen,500,5));
+}
+
+BOOST_AUTO_TEST_CASE(sux_fm_index_test_tokens)
+{
+  std::mt19937 gen
+  { 7 };
+  std::uniform_int_distribution<unsigned> dist
+  { 0 , 20 };
+  std::vector<unsigned> tokens;
+  for (std::size_t i = 0 ; i < 80000 ; ++i)
+    tokens.push_back(1000000u * dist(gen));
+  check_fm_index(tokens,make_patterns(tokens,gen,500,8));
+
+  const std::vector<unsigned> missing
+  { 5 };
+  const rlxalgo::fm::fm_index<unsigned,pos_type> index
+  { tokens.begin() , tokens.end() , 2 };
+  BOOST_CHECK(index.count(missing) == 0);
+}
@@ -0,0 +1,100 @@
+/*
+ * lcp_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LcpTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../lcp.hpp"
+
+/**
+ * LCP array computed by comparing each pair of neighbouring suffixes
+ * character by character.
+ */
+template <typename Pos, typename Text>
+std::vector<Pos> naive_lcp_array(const Text &text, const std::vector<Pos> &sux_array)
+{
+  std::vector<Pos> result(sux_array.size());
+  for (std::size_t i = 1 ; i < sux_array.size() ; ++i)
+    {
+      auto mismatch = std::mismatch(
+          begin(text) + std::max(sux_array[i-1],sux_array[i]),end(text),
+          begin(text) + std::min(sux_array[i-1],sux_array[i]));
+      result[i] = static_cast<Pos>(
+          std::distance(begin(text) + std::max(sux_array[i-1],sux_array[i]),mismatch.first));
+    }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(sux_lcp_test1)
+{
+  typedef unsigned int pos_type;
+
+  const std::string text
+  { "mississippi" };
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),1);
+  const std::vector<pos_type> expected
+  { 0 , 1 , 1 , 4 , 0 , 0 , 1 , 0 , 2 , 1 , 3 };
+  BOOST_CHECK(rlxalgo::lcp::make_lcp_array(text.begin(),text.end(),sux_array,1) == expected);
+  BOOST_CHECK(rlxalgo::lcp::make_lcp_array_sparse(text.begin(),text.end(),sux_array,1,4) == expected);
+
+  const std::string empty
+  { };
+  BOOST_CHECK(rlxalgo::lcp::make_lcp_array(empty.begin(),empty.end(),std::vector<pos_type>(),1).empty());
+  BOOST_CHECK_THROW(rlxalgo::lcp::make_lcp_array(text.begin(),text.end(),std::vector<pos_type>(3),1),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(sux_lcp_test_naive)
+{
+  typedef unsigned int pos_type;
+
+  std::vector<std::string> texts
+  { "a" , "ab" , "aaa" , "abracadabra" , std::string(30000,'x') };
+  std::string periodic;
+  for (std::size_t i = 0 ; i < 50000 ; ++i)
+    periodic.push_back("abaab"[i % 5]);
+  texts.push_back(periodic);
+
+  std::mt19937 gen
+  { 42 };
+  for (std::size_t alphsize : { 2 , 4 , 26 })
+    {
+      std::uniform_int_distribution<int> dist
+      { 0 , static_cast<int>(alphsize) - 1 };
+      std::string random_text;
+      for (std::size_t i = 0 ; i < 60000 ; ++i)
+        random_text.push_back('a' + dist(gen));
+      texts.push_back(random_text);
+      /* Long repeats inside random text. */
+      texts.push_back(random_text.substr(0,20000) + random_text.substr(0,20000) + random_text.substr(7,20000));
+    }
+
+  for (const auto &text : texts)
+    {
+      auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),2);
+      auto expected  = naive_lcp_array(text,sux_array);
+      for (unsigned threads : { 1 , 4 })
+        {
+          BOOST_CHECK_MESSAGE(
+              rlxalgo::lcp::make_lcp_array_phi(text.begin(),text.end(),sux_array,threads) == expected,
+              "Incorrect LCP array (phi) for text of length " << text.size());
+          for (unsigned sparseness : { 1 , 3 , 32 })
+            BOOST_CHECK_MESSAGE(
+                rlxalgo::lcp::make_lcp_array_sparse(text.begin(),text.end(),sux_array,threads,sparseness)
+                == expected,
+                "Incorrect LCP array (sparseness " << sparseness << ") for text of length " << text.size());
+        }
+    }
+}
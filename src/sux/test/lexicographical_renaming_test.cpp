@@ -11,10 +11,16 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+#include <chrono>
 #include <glog/logging.h>
 
 #include "../trigram.hpp"
 #include "../lexicographical_renaming.hpp"
+#include "../../util/parallelization.hpp"
+#include "../../util/random.hpp"
 #include "../../util/proctime.hpp"
 
 BOOST_AUTO_TEST_CASE(sux_builder_lexicographical_renaming)
@@ -127,3 +133,63 @@ BOOST_AUTO_TEST_CASE(sux_builder_lexicographical_renaming_skew)
 
   BOOST_CHECK(equal(begin(expected),end(expected),begin(name_str)));
 }
+
+/**
+ * Load-imbalance benchmark: Lexicographical renaming of the trigrams
+ * of a highly repetitive text. The boundary adjustment merges each run
+ * of identical trigrams into one portion, so with per-thread scheduling
+ * a single thread ends up doing most of the work. Stealing scheduling
+ * should compensate for this.
+ */
+BOOST_AUTO_TEST_CASE(sux_builder_lexicographical_renaming_imbalance)
+{
+  using std::setw;
+  using rlxutil::parallel::portions;
+  typedef rlxalgo::lexicographical_renaming lex;
+
+  typedef unsigned long                                        pos_type;
+  typedef sux::TrigramMaker<sux::TGImpl::pointer,char,pos_type> maker;
+  typedef std::chrono::duration<double,std::milli>             MS;
+
+  /* A random prefix, followed by many repetitions of a short pattern. */
+  constexpr std::size_t N = 8 * 1024 * 1024;
+  std::string text;
+  text.resize(N / 4);
+  std::generate_n(begin(text),N / 4,
+      rlxutil::RandomSequenceGeneratorUniform<char>('a','z'));
+  while (text.size() < N)
+    text.append("abcabd");
+
+  auto trigrams =
+      maker::make_23trigrams(text.begin(),text.end());
+  rlx::Alphabet<rlx::AlphabetClass::sparse,char,pos_type> alphabet
+  { };
+  sux::sort_23trigrams(trigrams,alphabet,4);
+
+  auto &eq = sux::trigram_tools::content_equal<sux::TGImpl::pointer,char,pos_type>;
+
+  portions per_thread
+  { trigrams.begin(), trigrams.end(), 4 };
+  auto tp1 = rlxutil::combined_clock<std::micro>::now();
+  auto expected = lex::apply(trigrams,per_thread,eq);
+  auto tp2 = rlxutil::combined_clock<std::micro>::now();
+
+  portions stealing
+  { };
+  stealing.set_scheduling(portions::scheduling::stealing);
+  stealing.assign(trigrams.begin(),trigrams.end(),4);
+  auto tp3 = rlxutil::combined_clock<std::micro>::now();
+  auto actual = lex::apply(trigrams,stealing,eq);
+  auto tp4 = rlxutil::combined_clock<std::micro>::now();
+
+  std::cout << setw(18) << "Portions:" << setw(10)
+      << per_thread.num() << " (per-thread), "
+      << stealing.num() << " (stealing)\n"
+      << setw(18) << "Per-thread:" << setw(10)
+      << std::chrono::duration_cast<MS>(tp2 - tp1) << '\n'
+      << setw(18) << "Stealing:" << setw(10)
+      << std::chrono::duration_cast<MS>(tp4 - tp3) << std::endl;
+
+  BOOST_CHECK(lex::alphsize(actual) == lex::alphsize(expected));
+  BOOST_CHECK(lex::newstring_of(actual) == lex::newstring_of(expected));
+}
@@ -0,0 +1,111 @@
+/*
+ * sais_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SaisTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../sais.hpp"
+#include "../suffix_array.hpp"
+
+/**
+ * Suffix array computed by sorting all suffixes using string
+ * comparison.
+ */
+template <typename Pos, typename Text>
+std::vector<Pos> naive_suffix_array(const Text &text)
+{
+  std::vector<Pos> result(text.size());
+  std::iota(begin(result),end(result),0);
+  std::sort(begin(result),end(result),
+      [&text](Pos lhs, Pos rhs)
+      { return std::lexicographical_compare(
+          begin(text) + lhs,end(text),begin(text) + rhs,end(text)); });
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_sais_test_naive)
+{
+  typedef unsigned int pos_type;
+
+  std::vector<std::string> texts
+  { "" , "a" , "ab" , "ba" , "aaa" , "mississippi" , "abracadabra" , "abxabcdabxfg" ,
+    "ruxxysaxaaabdyduuuusuxyabxbxbbsbaxuxyuxasuxytsysbbbstxusyxstauwwyqtqysxuxyssyswwbbababbwbbwwww" };
+  for (std::size_t len = 1 ; len < 40 ; ++len)
+    texts.push_back(std::string(len,'x'));
+  for (std::size_t len = 1 ; len < 40 ; ++len)
+    {
+      std::string periodic;
+      for (std::size_t i = 0 ; i < len ; ++i)
+        periodic.push_back("abaab"[i % 5]);
+      texts.push_back(periodic);
+    }
+
+  std::mt19937 gen
+  { 23 };
+  for (std::size_t alphsize : { 2 , 4 , 26 })
+    for (std::size_t len : { 100 , 1000 , 20000 })
+      {
+        std::uniform_int_distribution<int> dist
+        { 0 , static_cast<int>(alphsize) - 1 };
+        std::string random_text;
+        for (std::size_t i = 0 ; i < len ; ++i)
+          random_text.push_back('a' + dist(gen));
+        texts.push_back(random_text);
+      }
+
+  for (const auto &text : texts)
+    {
+      auto suffix_array =
+          rlxalgo::sais::make_suffix_array<pos_type>(text.begin(),text.end(),2);
+      BOOST_CHECK_MESSAGE(suffix_array == naive_suffix_array<pos_type>(text),
+          "Incorrect suffix array for text of length " << text.size());
+    }
+
+  /* All 256 byte values, which requires widening the text. */
+  std::vector<unsigned char> bytes;
+  for (int round = 0 ; round < 20 ; ++round)
+    for (int c = 0 ; c < 256 ; ++c)
+      bytes.push_back(static_cast<unsigned char>((c * 7 + round * round) % 256));
+  BOOST_CHECK(rlxalgo::sais::make_suffix_array<pos_type>(bytes.begin(),bytes.end(),2)
+      == naive_suffix_array<pos_type>(bytes));
+
+  /* Position type that is too small. */
+  std::string long_text(70000,'a');
+  BOOST_CHECK_THROW(
+      rlxalgo::sais::make_suffix_array<unsigned short>(long_text.begin(),long_text.end(),1),
+      std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_sa_engine_test)
+{
+  using rlxalgo::SAEngine;
+  typedef unsigned int pos_type;
+
+  std::mt19937 gen
+  { 5 };
+  std::uniform_int_distribution<int> dist
+  { 0 , 3 };
+  std::string text;
+  for (int i = 0 ; i < 100000 ; ++i)
+    text.push_back("acgt"[dist(gen)]);
+
+  auto skew_sa =
+      rlxalgo::make_suffix_array<pos_type,SAEngine::skew>(text.begin(),text.end(),2);
+  auto sais_sa =
+      rlxalgo::make_suffix_array<pos_type,SAEngine::sais>(text.begin(),text.end(),2);
+  BOOST_CHECK(skew_sa == sais_sa);
+  BOOST_CHECK(rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),2) == skew_sa);
+}
@@ -0,0 +1,85 @@
+/*
+ * sampled_sa_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SampledSaTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../sampled_sa.hpp"
+
+typedef unsigned int pos_type;
+
+/**
+ * Check every value of the compressed suffix array against the full
+ * suffix array, for several sampling rates.
+ */
+template <typename Text>
+void check_sampled_sa(const Text &text)
+{
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(begin(text),end(text),2);
+  for (pos_type rate : { 1 , 2 , 7 , 32 , 100 })
+    {
+      const rlxalgo::fm::sampled_suffix_array<typename Text::value_type,pos_type> csa
+      { begin(text) , end(text) , sux_array , rate , 3 };
+      BOOST_CHECK(csa.size() == sux_array.size());
+      bool correct
+      { true };
+      for (pos_type i = 0 ; i < csa.size() ; ++i)
+        correct = correct && csa[i] == sux_array[i];
+      BOOST_CHECK_MESSAGE(correct,"Incorrect suffix array value for text of length "
+          << text.size() << " and sampling rate " << rate);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sux_sampled_sa_test1)
+{
+  const std::string text
+  { "mississippi" };
+  auto csa = rlxalgo::fm::make_sampled_suffix_array<pos_type>(text.begin(),text.end(),4,1);
+
+  /* Suffix array: 10 7 4 1 0 9 8 6 3 5 2 */
+  const std::vector<pos_type> expected
+  { 10 , 7 , 4 , 1 , 0 , 9 , 8 , 6 , 3 , 5 , 2 };
+  std::vector<pos_type> actual;
+  for (pos_type i = 0 ; i < csa.size() ; ++i)
+    actual.push_back(csa[i]);
+  BOOST_CHECK(actual == expected);
+  BOOST_CHECK(csa.count(std::string("ssi")) == 2);
+  BOOST_CHECK((csa.locate(std::string("ssi")) == std::vector<pos_type> { 5 , 2 }));
+  BOOST_CHECK(csa.locate(std::string("x")).empty());
+
+  const std::string empty
+  { };
+  auto empty_csa = rlxalgo::fm::make_sampled_suffix_array<pos_type>(empty.begin(),empty.end(),4,1);
+  BOOST_CHECK(empty_csa.size() == 0);
+  BOOST_CHECK(empty_csa.locate(std::string("a")).empty());
+}
+
+BOOST_AUTO_TEST_CASE(sux_sampled_sa_test_random)
+{
+  std::mt19937 gen
+  { 11 };
+  std::uniform_int_distribution<int> dist
+  { 0 , 3 };
+  std::string text;
+  for (std::size_t i = 0 ; i < 100000 ; ++i)
+    text.push_back('a' + dist(gen));
+  check_sampled_sa(text);
+  check_sampled_sa(std::string(5000,'x'));
+
+  std::vector<unsigned> tokens;
+  for (std::size_t i = 0 ; i < 20000 ; ++i)
+    tokens.push_back(7u * dist(gen) + 100000u);
+  check_sampled_sa(tokens);
+}
@@ -0,0 +1,260 @@
+/*
+ * search_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SearchTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include "../suffix_array.hpp"
+#include "../lcp.hpp"
+#include "../search.hpp"
+
+typedef unsigned int pos_type;
+
+/**
+ * The occurrences of a pattern, found by comparing it to every
+ * position of the text.
+ */
+template <typename Text, typename Pattern>
+std::vector<pos_type> naive_occurrences(const Text &text, const Pattern &pattern)
+{
+  std::vector<pos_type> result;
+  for (std::size_t pos = 0 ; pos + pattern.size() <= text.size() ; ++pos)
+    if (std::equal(begin(pattern),end(pattern),begin(text) + pos))
+      result.push_back(static_cast<pos_type>(pos));
+  return result;
+}
+
+/**
+ * Search every pattern with both the mlr and the LCP-accelerated
+ * searcher, and compare the occurrences to those found naively.
+ */
+template <typename Text>
+void check_search(const Text &text, const std::vector<Text> &patterns)
+{
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(begin(text),end(text),2);
+  auto lcp       = rlxalgo::lcp::make_lcp_array(begin(text),end(text),sux_array,2);
+  auto mlr_searcher = rlxalgo::search::make_searcher(text,sux_array);
+  auto lcp_searcher = rlxalgo::search::make_searcher(text,sux_array,lcp);
+
+  for (const auto &pattern : patterns)
+    {
+      const auto expected = naive_occurrences(text,pattern);
+      BOOST_CHECK(mlr_searcher.find(pattern) == lcp_searcher.find(pattern));
+      BOOST_CHECK(lcp_searcher.count(pattern) == expected.size());
+
+      auto range = lcp_searcher.locate(pattern);
+      std::vector<pos_type> actual(range.first,range.second);
+      std::sort(begin(actual),end(actual));
+      BOOST_CHECK_MESSAGE(actual == expected,
+          "Incorrect occurrences for pattern of length " << pattern.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sux_search_test1)
+{
+  const std::string text
+  { "mississippi" };
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),1);
+  auto searcher  = rlxalgo::search::make_searcher(text,sux_array);
+
+  /* Suffix array: 10 7 4 1 0 9 8 6 3 5 2 */
+  BOOST_CHECK((searcher.find(std::string("ssi")) == rlxalgo::search::sa_interval<pos_type> { 9 , 11 }));
+  BOOST_CHECK((searcher.find(std::string("i")) == rlxalgo::search::sa_interval<pos_type> { 0 , 4 }));
+  BOOST_CHECK((searcher.find(std::string("")) == rlxalgo::search::sa_interval<pos_type> { 0 , 11 }));
+  BOOST_CHECK(searcher.count(std::string("issip")) == 1);
+  BOOST_CHECK(searcher.count(std::string("mississippis")) == 0);
+  BOOST_CHECK(searcher.count(std::string("a")) == 0);
+  BOOST_CHECK(searcher.count(std::string("z")) == 0);
+  BOOST_CHECK(*searcher.locate(std::string("pp")).first == 8);
+
+  const std::string empty
+  { };
+  const std::vector<pos_type> empty_sux_array
+  { };
+  auto empty_searcher = rlxalgo::search::make_searcher(empty,empty_sux_array,empty_sux_array);
+  BOOST_CHECK(empty_searcher.count(std::string("a")) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sux_search_test_naive)
+{
+  std::mt19937 gen
+  { 7 };
+
+  /* Characters. */
+  for (int alphsize : { 2 , 4 , 26 })
+    {
+      std::uniform_int_distribution<int> dist
+      { 0 , alphsize - 1 };
+      std::string text;
+      for (std::size_t i = 0 ; i < 20000 ; ++i)
+        text.push_back('a' + dist(gen));
+      text += text.substr(100,3000);
+
+      std::vector<std::string> patterns;
+      std::uniform_int_distribution<std::size_t> pos_dist
+      { 0 , text.size() - 1 };
+      for (std::size_t len : { 1 , 2 , 3 , 5 , 8 , 13 , 40 , 1000 })
+        for (int i = 0 ; i < 30 ; ++i)
+          {
+            std::string pattern = text.substr(pos_dist(gen),len);
+            patterns.push_back(pattern);
+            /* Modified patterns, likely without occurrences. */
+            pattern.back() = 'a' + dist(gen);
+            patterns.push_back(pattern);
+            pattern.front() = 'a' + alphsize;
+            patterns.push_back(pattern);
+          }
+      check_search(text,patterns);
+    }
+
+  /* Integer tokens. */
+  std::uniform_int_distribution<unsigned> token_dist
+  { 0 , 50 };
+  std::vector<unsigned> tokens;
+  for (std::size_t i = 0 ; i < 10000 ; ++i)
+    tokens.push_back(token_dist(gen) * 1000);
+  std::vector<std::vector<unsigned>> token_patterns;
+  for (std::size_t i = 0 ; i + 4 < tokens.size() ; i += 97)
+    {
+      token_patterns.emplace_back(tokens.begin() + i,tokens.begin() + i + 1 + i % 4);
+      token_patterns.emplace_back(tokens.begin() + i,tokens.begin() + i + 1 + i % 4);
+      token_patterns.back().back() += 1;
+    }
+  check_search(tokens,token_patterns);
+
+  /* A periodic text, where many suffixes share long prefixes. */
+  std::string periodic;
+  for (std::size_t i = 0 ; i < 5000 ; ++i)
+    periodic.push_back("abaab"[i % 5]);
+  check_search(periodic,std::vector<std::string> { "abaab" , "baababaab" , periodic.substr(3,400) ,
+    periodic.substr(0,4990) + "b" , "aaa" , "b" });
+}
+
+BOOST_AUTO_TEST_CASE(sux_search_test_kmer)
+{
+  std::mt19937 gen
+  { 11 };
+
+  /* Small alphabets, and all byte values including 0 and the
+   * negative chars. */
+  std::vector<std::string> texts
+  { "mississippi" , "aaaaaaaaaa" , "ab" };
+  for (int alphsize : { 3 , 256 })
+    {
+      std::uniform_int_distribution<int> dist
+      { 0 , alphsize - 1 };
+      std::string text;
+      for (std::size_t i = 0 ; i < 30000 ; ++i)
+        text.push_back(static_cast<char>(alphsize == 256 ? dist(gen) : 'a' + dist(gen)));
+      texts.push_back(text);
+    }
+
+  for (const auto &text : texts)
+    {
+      auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),2);
+      auto searcher  = rlxalgo::search::make_searcher(text,sux_array);
+
+      std::vector<std::string> patterns;
+      std::uniform_int_distribution<std::size_t> pos_dist
+      { 0 , text.size() - 1 };
+      for (std::size_t len : { 1 , 2 , 3 , 4 , 6 , 20 })
+        for (int i = 0 ; i < 40 ; ++i)
+          {
+            std::string pattern = text.substr(pos_dist(gen),len);
+            patterns.push_back(pattern);
+            pattern.back() = static_cast<char>(pattern.back() + 1);
+            patterns.push_back(pattern);
+          }
+      /* Suffixes shorter than k. */
+      patterns.push_back(text.substr(text.size() - 1));
+      patterns.push_back(text.substr(text.size() - 1) + std::string(2,'\0'));
+
+      for (unsigned k : { 1 , 2 , 3 })
+        {
+          searcher.make_kmer_table(k,3);
+          for (const auto &pattern : patterns)
+            {
+              const auto expected = naive_occurrences(text,pattern);
+              auto range = searcher.locate(pattern);
+              std::vector<pos_type> actual(range.first,range.second);
+              std::sort(begin(actual),end(actual));
+              BOOST_CHECK_MESSAGE(actual == expected,
+                  "Incorrect occurrences with " << k << "-mer table for pattern of length "
+                  << pattern.size() << " in text of length " << text.size());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sux_search_test_batch)
+{
+  std::mt19937 gen
+  { 5 };
+  std::uniform_int_distribution<int> dist
+  { 0 , 3 };
+  std::string text;
+  for (std::size_t i = 0 ; i < 50000 ; ++i)
+    text.push_back('a' + dist(gen));
+
+  auto sux_array = rlxalgo::make_suffix_array<pos_type>(text.begin(),text.end(),2);
+  auto searcher  = rlxalgo::search::make_searcher(text,sux_array);
+
+  /* Patterns with repetitions, common prefixes, and patterns without
+   * occurrences. */
+  std::vector<std::string> patterns
+  { "" , "e" , "a" , text.substr(0,100) , text.substr(text.size() - 3) };
+  std::uniform_int_distribution<std::size_t> pos_dist
+  { 0 , text.size() - 30 };
+  for (int i = 0 ; i < 2000 ; ++i)
+    {
+      const std::string pattern = text.substr(pos_dist(gen),1 + i % 25);
+      patterns.push_back(pattern);
+      patterns.push_back(pattern.substr(0,pattern.size() / 2));
+      if (i % 7 == 0)
+        patterns.push_back(pattern);
+      if (i % 5 == 0)
+        patterns.push_back(pattern + "e");
+    }
+
+  for (unsigned k : { 0 , 2 })
+    {
+      if (k > 0)
+        searcher.make_kmer_table(k,2);
+      auto actual = searcher.find_batch(patterns);
+      BOOST_CHECK(actual.size() == patterns.size());
+      bool correct
+      { true };
+      for (std::size_t i = 0 ; i < patterns.size() ; ++i)
+        if (!(actual[i] == searcher.find(patterns[i]))
+            || (!patterns[i].empty()
+                && actual[i].size() != naive_occurrences(text,patterns[i]).size()))
+          correct = false;
+      BOOST_CHECK_MESSAGE(correct,"Incorrect batch search result (k=" << k << ")");
+    }
+  BOOST_CHECK(searcher.find_batch(std::vector<std::string>()).empty());
+
+  /* Integer tokens. */
+  std::vector<unsigned> tokens(text.begin(),text.end());
+  auto token_searcher = rlxalgo::search::make_searcher(tokens,sux_array);
+  std::vector<std::vector<unsigned>> token_patterns;
+  for (const auto &pattern : patterns)
+    token_patterns.emplace_back(pattern.begin(),pattern.end());
+  auto token_actual = token_searcher.find_batch(token_patterns);
+  bool correct
+  { true };
+  for (std::size_t i = 0 ; i < token_patterns.size() ; ++i)
+    if (!(token_actual[i] == searcher.find(patterns[i])))
+      correct = false;
+  BOOST_CHECK(correct);
+}
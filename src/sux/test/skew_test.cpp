@@ -11,11 +11,21 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
 #include <glog/logging.h>
 
 #include "../trigram.hpp"
 #include "../lexicographical_renaming.hpp"
 #include "../skew.hpp"
+#include "../dcx.hpp"
+#include "../../util/random.hpp"
+#include "../../util/proctime.hpp"
 
 BOOST_AUTO_TEST_CASE(sux_builder_skew_make_s0_test)
 {
@@ -71,11 +81,24 @@ BOOST_AUTO_TEST_CASE(sux_builder_skew_make_s0_test)
   BOOST_CHECK(equal(begin(expected),end(expected),begin(s0_trigrams)));
 }
 
-BOOST_AUTO_TEST_CASE(sux_builder_skew_test1)
+/**
+ * Suffix array computed by sorting all suffixes using string
+ * comparison.
+ */
+template <typename Pos, typename Text>
+std::vector<Pos> naive_suffix_array(const Text &text)
 {
-  using sux::trigram_tools::to_str;
-  using sux::trigram_tools::pos_of;
+  std::vector<Pos> result(text.size());
+  std::iota(begin(result),end(result),0);
+  std::sort(begin(result),end(result),
+      [&text](Pos lhs, Pos rhs)
+      { return std::lexicographical_compare(
+          begin(text) + lhs,end(text),begin(text) + rhs,end(text)); });
+  return result;
+}
 
+BOOST_AUTO_TEST_CASE(sux_builder_skew_test1)
+{
   typedef unsigned short pos_type;
 
   std::string text
@@ -84,5 +107,175 @@ BOOST_AUTO_TEST_CASE(sux_builder_skew_test1)
   auto suffix_array =
       rlxalgo::skew::make_suffix_array<pos_type>(text.begin(),text.end(),1);
 
+  std::vector<pos_type> expected
+  { 3 , 0 , 7 , 4 , 1 , 8 , 5 , 6 , 10 , 11 , 2 , 9 };
+  BOOST_CHECK(suffix_array == expected);
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_skew_test_naive)
+{
+  typedef unsigned int pos_type;
+
+  /* Short texts of all lengths, including those that require
+   * a dummy trigram, and highly repetitive ones that require
+   * several levels of recursion. */
+  std::vector<std::string> texts
+  { "" , "a" , "ab" , "ba" , "aaa" , "mississippi" , "abracadabra" ,
+    "ruxxysaxaaabdyduuuusuxyabxbxbbsbaxuxyuxasuxytsysbbbstxusyxstauwwyqtqysxuxyssyswwbbababbwbbwwww" };
+  for (std::size_t len = 1 ; len < 40 ; ++len)
+    texts.push_back(std::string(len,'x'));
+  for (std::size_t len = 1 ; len < 40 ; ++len)
+    {
+      std::string periodic;
+      for (std::size_t i = 0 ; i < len ; ++i)
+        periodic.push_back("abaab"[i % 5]);
+      texts.push_back(periodic);
+    }
+
+  std::mt19937 gen
+  { 17 };
+  for (std::size_t alphsize : { 2 , 4 , 26 })
+    for (std::size_t len : { 100 , 1000 , 20000 })
+      {
+        std::uniform_int_distribution<int> dist
+        { 0 , static_cast<int>(alphsize) - 1 };
+        std::string random_text;
+        for (std::size_t i = 0 ; i < len ; ++i)
+          random_text.push_back('a' + dist(gen));
+        texts.push_back(random_text);
+      }
+
+  using rlxalgo::skew::MergeLayout;
+  for (const auto &text : texts)
+    for (unsigned threads : { 1 , 3 })
+      {
+        const auto expected = naive_suffix_array<pos_type>(text);
+        auto colocated =
+            rlxalgo::skew::make_suffix_array<pos_type>(text.begin(),text.end(),threads);
+        BOOST_CHECK_MESSAGE(colocated == expected,
+            "Incorrect suffix array for text of length " << text.size());
+        auto direct =
+            rlxalgo::skew::make_suffix_array<pos_type,MergeLayout::direct>(
+                text.begin(),text.end(),threads);
+        BOOST_CHECK_MESSAGE(direct == expected,
+            "Incorrect suffix array (direct merge) for text of length " << text.size());
+      }
+
+  /* All 256 byte values, so the compacted characters must be widened
+   * to make room for the sentinel. */
+  std::vector<unsigned char> bytes;
+  for (int round = 0 ; round < 20 ; ++round)
+    for (int c = 0 ; c < 256 ; ++c)
+      bytes.push_back(static_cast<unsigned char>((c * 7 + round * round) % 256));
+  auto suffix_array =
+      rlxalgo::skew::make_suffix_array<pos_type>(bytes.begin(),bytes.end(),2);
+  BOOST_CHECK(suffix_array == naive_suffix_array<pos_type>(bytes));
+
+  /* Integer texts. */
+  std::vector<unsigned long> ints;
+  std::uniform_int_distribution<unsigned long> int_dist
+  { 0 , 5 };
+  for (int i = 0 ; i < 5000 ; ++i)
+    ints.push_back(int_dist(gen) * 1000000007UL);
+  auto int_suffix_array =
+      rlxalgo::skew::make_suffix_array<pos_type>(ints.begin(),ints.end(),2);
+  BOOST_CHECK(int_suffix_array == naive_suffix_array<pos_type>(ints));
+}
+
+template <typename Cover>
+void check_dcx_against_naive()
+{
+  typedef unsigned int pos_type;
+
+  std::vector<std::string> texts
+  { "" , "a" , "ab" , "ba" , "aaa" , "mississippi" , "abracadabra" , "abxabcdabxfg" };
+  for (std::size_t len = 1 ; len < 60 ; ++len)
+    texts.push_back(std::string(len,'x'));
+  for (std::size_t len = 1 ; len < 60 ; ++len)
+    {
+      std::string periodic;
+      for (std::size_t i = 0 ; i < len ; ++i)
+        periodic.push_back("abaababa"[i % 8]);
+      texts.push_back(periodic);
+    }
+
+  std::mt19937 gen
+  { 31 };
+  for (std::size_t alphsize : { 2 , 4 , 26 })
+    for (std::size_t len : { 100 , 1000 , 20000 })
+      {
+        std::uniform_int_distribution<int> dist
+        { 0 , static_cast<int>(alphsize) - 1 };
+        std::string random_text;
+        for (std::size_t i = 0 ; i < len ; ++i)
+          random_text.push_back('a' + dist(gen));
+        texts.push_back(random_text);
+      }
+  /* Highly repetitive text with deep recursion. */
+  std::string repetitive;
+  while (repetitive.size() < 5000)
+    repetitive.append("the cat sat on the mat. ");
+  texts.push_back(repetitive);
+
+  for (const auto &text : texts)
+    for (unsigned threads : { 1 , 3 })
+      {
+        auto suffix_array =
+            rlxalgo::dcx::make_suffix_array<pos_type,Cover>(text.begin(),text.end(),threads);
+        BOOST_CHECK_MESSAGE(suffix_array == naive_suffix_array<pos_type>(text),
+            "Incorrect DC" << Cover::period << " suffix array for text of length " << text.size());
+      }
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_dcx_test)
+{
+  /* The difference cover property. */
+  rlxalgo::dcx::cover_table<rlxalgo::dcx::dc13> table;
+  for (unsigned r1 = 0 ; r1 < 13 ; ++r1)
+    for (unsigned r2 = 0 ; r2 < 13 ; ++r2)
+      {
+        BOOST_CHECK(table._delta[r1][r2] < 13);
+        BOOST_CHECK(table.is_member((r1 + table._delta[r1][r2]) % 13));
+        BOOST_CHECK(table.is_member((r2 + table._delta[r1][r2]) % 13));
+      }
+
+  check_dcx_against_naive<rlxalgo::dcx::dc3>();
+  check_dcx_against_naive<rlxalgo::dcx::dc7>();
+  check_dcx_against_naive<rlxalgo::dcx::dc13>();
+}
+
+/**
+ * Compares the two memory layouts of the merge on a large
+ * text.
+ */
+BOOST_AUTO_TEST_CASE(sux_builder_skew_merge_layout_benchmark)
+{
+  using std::setw;
+  using rlxalgo::skew::MergeLayout;
+
+  typedef unsigned int                             pos_type;
+  typedef std::chrono::duration<double,std::milli> MS;
+
+  /* Generate a random string of 100m characters. */
+  constexpr std::size_t N = 100 * 1024 * 1024;
+  std::string text;
+  text.resize(N);
+  std::generate_n(begin(text),N,
+      rlxutil::RandomSequenceGeneratorUniform<char>('a','z'));
+
+  auto tp1 = rlxutil::combined_clock<std::micro>::now();
+  auto direct =
+      rlxalgo::skew::make_suffix_array<pos_type,MergeLayout::direct>(text.begin(),text.end(),4);
+  auto tp2 = rlxutil::combined_clock<std::micro>::now();
+  auto colocated =
+      rlxalgo::skew::make_suffix_array<pos_type,MergeLayout::colocated>(text.begin(),text.end(),4);
+  auto tp3 = rlxutil::combined_clock<std::micro>::now();
+
+  std::cout << setw(18) << "Text length:" << setw(10) << N << '\n'
+      << setw(18) << "Direct merge:" << setw(10)
+      << std::chrono::duration_cast<MS>(tp2 - tp1) << '\n'
+      << setw(18) << "Colocated merge:" << setw(10)
+      << std::chrono::duration_cast<MS>(tp3 - tp2) << std::endl;
 
+  BOOST_CHECK(direct == colocated);
 }
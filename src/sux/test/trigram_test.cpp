@@ -12,6 +12,7 @@
 #include <glog/logging.h>
 
 #include "../trigram.hpp"
+#include "../qgram.hpp"
 #include "../alphabet.hpp"
 #include "../../util/random.hpp"
 #include "../../util/proctime.hpp"
@@ -45,6 +46,10 @@ typedef sux::TrigramMaker<sux::TGImpl::tuple,Char,LPos> LTMaker;
 typedef LTMaker::trigram_type     LTTrigram;
 typedef LTMaker::trigram_vec_type LTTrigrams;
 
+typedef sux::TrigramMaker<sux::TGImpl::packed,Char,LPos> LKMaker;
+typedef LKMaker::trigram_type     LKTrigram;
+typedef LKMaker::trigram_vec_type LKTrigrams;
+
 
 BOOST_AUTO_TEST_CASE(sux_builder_trigram_test_3)
 {
@@ -124,6 +129,76 @@ BOOST_AUTO_TEST_CASE(sux_builder_trigram_test_8)
       && (equal(begin(actual),end(actual),begin(expected)))));
 }
 
+BOOST_AUTO_TEST_CASE(sux_builder_trigram_test_packed)
+{
+  using sux::trigram_tools::pos_of;
+  using sux::trigram_tools::content_equal;
+
+  static_assert(sizeof(LKTrigram) == 8,
+      "Packed trigrams of 8-bit characters should fit into 64 bits");
+
+  const std::basic_string<Char> input { (const Char *)"abcdefgh" };
+  LKTrigrams expected {
+    LKTrigram { 1,'b','c','d' },
+    LKTrigram { 2,'c','d','e' },
+    LKTrigram { 4,'e','f','g' },
+    LKTrigram { 5,'f','g','h' }
+  };
+
+  LKTrigrams actual = LKMaker::make_23trigrams(begin(input),end(input));
+  BOOST_CHECK((actual.size() == expected.size()
+      && (equal(begin(actual),end(actual),begin(expected)))));
+
+  BOOST_CHECK(pos_of(actual[2]) == 4);
+  BOOST_CHECK(sux::triget1(actual[2]) == 'e');
+  BOOST_CHECK(sux::triget2(actual[2]) == 'f');
+  BOOST_CHECK(sux::triget3(actual[2]) == 'g');
+  BOOST_CHECK(!content_equal(actual[0],actual[1]));
+  BOOST_CHECK(content_equal(actual[0],LKTrigram(7,'b','c','d')));
+
+  /* Signed and wide characters keep their order in the key. */
+  typedef sux::TrigramImpl<sux::TGImpl::packed,char,LPos>    signed_type;
+  typedef sux::TrigramImpl<sux::TGImpl::packed,char16_t,LPos> wide_type;
+  BOOST_CHECK(signed_type(0,-5,'a','b').key() < signed_type(0,3,'a','b').key());
+  BOOST_CHECK(signed_type(9,-5,'a','b').get1() == -5);
+  BOOST_CHECK(wide_type(3,0x3042,'x',0xffff).get3() == 0xffff);
+  BOOST_CHECK(wide_type(3,0x3042,'x',0xffff).pos() == 3);
+}
+
+/**
+ * Auxiliary function that checks that parallel trigram generation
+ * produces the same result as sequential generation, for text lengths
+ * of all residues modulo 3.
+ */
+template <sux::TGImpl tgimpl>
+void perform_parallel_trigram_generation()
+{
+  typedef sux::TrigramMaker<tgimpl,Char,LPos> TrigramMaker;
+
+  for (std::size_t N : { 0 , 2 , 3 , 4 , 5 , 100000 , 100001 , 100002 , 1000000 })
+    {
+      std::basic_string<Char> input;
+      input.resize(N);
+      std::generate_n(begin(input),N,
+          rlxutil::RandomSequenceGeneratorUniform<Char>('a','z'));
+
+      auto expected = TrigramMaker::make_23trigrams(begin(input),end(input));
+      auto actual   = TrigramMaker::make_23trigrams(begin(input),end(input),4);
+
+      BOOST_CHECK(expected.size() == sux::trigram_tools::num_23trigrams(N));
+      BOOST_CHECK((actual.size() == expected.size()
+          && (equal(begin(actual),end(actual),begin(expected)))));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_trigram_test_parallel)
+{
+  perform_parallel_trigram_generation<sux::TGImpl::tuple>();
+  perform_parallel_trigram_generation<sux::TGImpl::arraytuple>();
+  perform_parallel_trigram_generation<sux::TGImpl::pointer>();
+  perform_parallel_trigram_generation<sux::TGImpl::packed>();
+}
+
 BOOST_AUTO_TEST_CASE(sux_builder_chardistribution_test)
 {
   using rlx::Alphabet;
@@ -133,23 +208,192 @@ BOOST_AUTO_TEST_CASE(sux_builder_chardistribution_test)
   typedef Alphabet<AlphabetClass::sparse,Char,Pos> alphabet_type;
   typedef typename alphabet_type::char_freq_type   freq_type;
   typedef typename alphabet_type::freq_table_type  table_type;
-  table_type expected {
-    { 'a',0 },
-    { 'b',2 },
-    { 'c',7 }
-  };
+
+  /* 8-bit characters use a flat table. */
+  static_assert(std::is_same<table_type,rlx::DenseFreqTable<Char,Pos>>::value,
+      "Sparse alphabets of 8-bit characters must use dense frequency tables");
 
   alphabet_type alphabet
   { };
 
   auto actual = rlx::alphabet_tools::make_freq_table(
       begin(input),end(input),sux::cid<Char>,alphabet);
+  std::vector<freq_type> chars;
+  alphabet_type::for_each_char(actual,
+      [&chars](Char c, Pos freq) { chars.emplace_back(c,freq); });
+  BOOST_CHECK((chars == std::vector<freq_type> { { 'a',2 } , { 'b',5 } , { 'c',3 } }));
+
   alphabet_type::make_cumulative(actual);
-  BOOST_CHECK(actual.size() == 3);
-  BOOST_CHECK(equal(begin(actual),end(actual),begin(expected),
-      [](const freq_type &f1, const freq_type &f2){
-    return ((f1.first == f2.first) && (f1.second == f2.second));
-  }));
+  BOOST_CHECK(actual.size() == 256);
+  BOOST_CHECK(actual['a'] == 0);
+  BOOST_CHECK(actual['b'] == 2);
+  BOOST_CHECK(actual['c'] == 7);
+  BOOST_CHECK(actual['d'] == 10);
+
+  /* Signed characters are arranged in character order. */
+  typedef Alphabet<AlphabetClass::sparse,signed char,Pos> signed_alphabet_type;
+  const std::vector<signed char> signed_input { 5, -3, 0, -128, 127, -3 };
+  signed_alphabet_type signed_alphabet
+  { };
+  auto signed_table = rlx::alphabet_tools::make_freq_table(
+      begin(signed_input),end(signed_input),[](signed char c) { return c; },signed_alphabet);
+  std::vector<std::pair<signed char,Pos>> signed_chars;
+  signed_alphabet_type::for_each_char(signed_table,
+      [&signed_chars](signed char c, Pos freq) { signed_chars.emplace_back(c,freq); });
+  BOOST_CHECK((signed_chars == std::vector<std::pair<signed char,Pos>>
+      { { -128,1 } , { -3,2 } , { 0,1 } , { 5,1 } , { 127,1 } }));
+
+  /* Wide characters keep using maps. */
+  typedef Alphabet<AlphabetClass::sparse,unsigned,Pos> wide_alphabet_type;
+  typedef typename wide_alphabet_type::freq_table_type wide_table_type;
+  static_assert(std::is_same<wide_table_type,std::map<unsigned,Pos>>::value,
+      "Sparse alphabets of 32-bit characters must use maps as frequency tables");
+  const std::vector<unsigned> wide_input { 70000, 3, 70000, 1u << 31 };
+  wide_alphabet_type wide_alphabet
+  { };
+  auto wide_table = rlx::alphabet_tools::make_freq_table(
+      begin(wide_input),end(wide_input),[](unsigned c) { return c; },wide_alphabet);
+  wide_alphabet_type::make_cumulative(wide_table);
+  BOOST_CHECK(wide_table.size() == 3);
+  BOOST_CHECK(wide_table[3] == 0 && wide_table[70000] == 1 && wide_table[1u << 31] == 3);
+}
+
+/**
+ * Compute per-thread write offsets the straightforward way, as reference
+ * for `make_cumulative()` applied to a list of frequency tables.
+ */
+std::vector<std::vector<LPos>> reference_thread_offsets(
+    const std::vector<std::vector<LPos>> &tables)
+{
+  std::vector<std::vector<LPos>> result(tables.size(),std::vector<LPos>(tables.front().size()));
+  LPos total
+  { 0 };
+  for (std::size_t c = 0 ; c < tables.front().size() ; ++c)
+    for (std::size_t t = 0 ; t < tables.size() ; ++t)
+      {
+        result[t][c] = total;
+        total += tables[t][c];
+      }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_thread_cumulative_test)
+{
+  using rlx::Alphabet;
+  using rlx::AlphabetClass;
+
+  /* Zero-range alphabet large enough to be scanned in parallel. */
+  typedef Alphabet<AlphabetClass::zero_range,LPos,LPos> range_alphabet_type;
+  constexpr std::size_t sigma = 100000;
+  rlxutil::RandomSequenceGeneratorUniform<LPos> random_freq(0,20);
+  std::vector<std::vector<LPos>> range_tables(4,std::vector<LPos>(sigma));
+  for (auto &table : range_tables)
+    std::generate(begin(table),end(table),random_freq);
+  auto expected = reference_thread_offsets(range_tables);
+  range_alphabet_type::make_cumulative(range_tables,4);
+  BOOST_CHECK(range_tables == expected);
+
+  /* Dense tables of a sparse alphabet. */
+  typedef Alphabet<AlphabetClass::sparse,Char,LPos> dense_alphabet_type;
+  const std::basic_string<Char> input { (const Char *)"abracadabra" };
+  std::vector<dense_alphabet_type::freq_table_type> dense_tables;
+  for (std::size_t t = 0 ; t < 3 ; ++t)
+    dense_tables.push_back(rlx::alphabet_tools::make_freq_table(
+        begin(input) + 4*t,begin(input) + std::min<std::size_t>(4*t + 4,input.size()),
+        [](Char c) { return c; },dense_alphabet_type()));
+  dense_alphabet_type::make_cumulative(dense_tables,3);
+  /* abra|cada|bra: 5 a, 2 b, 1 c, 1 d, 2 r */
+  BOOST_CHECK(dense_tables[0]['a'] == 0 && dense_tables[1]['a'] == 2 && dense_tables[2]['a'] == 4);
+  BOOST_CHECK(dense_tables[0]['b'] == 5 && dense_tables[1]['b'] == 6 && dense_tables[2]['b'] == 6);
+  BOOST_CHECK(dense_tables[0]['c'] == 7 && dense_tables[1]['c'] == 7 && dense_tables[2]['c'] == 8);
+  BOOST_CHECK(dense_tables[0]['r'] == 9 && dense_tables[1]['r'] == 10 && dense_tables[2]['r'] == 10);
+
+  /* Map-based tables of a sparse alphabet. */
+  typedef Alphabet<AlphabetClass::sparse,unsigned,LPos> map_alphabet_type;
+  std::vector<map_alphabet_type::freq_table_type> map_tables
+  { { { 7,2 } , { 100,1 } } , { { 3,1 } , { 100,2 } } };
+  map_alphabet_type::make_cumulative(map_tables,2);
+  BOOST_CHECK(map_tables[0][3] == 0 && map_tables[1][3] == 0);
+  BOOST_CHECK(map_tables[0][7] == 1 && map_tables[1][7] == 3);
+  BOOST_CHECK(map_tables[0][100] == 3 && map_tables[1][100] == 4);
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_buffered_bucket_sort_test)
+{
+  using rlx::Alphabet;
+  using rlx::AlphabetClass;
+  typedef Alphabet<AlphabetClass::zero_range,LPos,LPos> alphabet_type;
+  typedef std::vector<LKTrigram>::iterator              It;
+
+  /* Packed trigrams, bucketed by a 10-bit key. */
+  constexpr std::size_t N = 1024 * 1024;
+  std::basic_string<Char> input;
+  input.resize(N);
+  std::generate_n(begin(input),N,
+      rlxutil::RandomSequenceGeneratorUniform<Char>(0,255));
+  auto trigrams = LKMaker::make_23trigrams(begin(input),end(input),4);
+  auto key = [](const LKTrigram &tri) { return static_cast<LPos>(tri.pos() % 1000); };
+
+  alphabet_type alphabet
+  { 1000 };
+  auto bucket_sizes = rlx::alphabet_tools::make_freq_table(
+      begin(trigrams),end(trigrams),key,alphabet);
+  alphabet_type::make_cumulative(bucket_sizes);
+  auto direct_sizes = bucket_sizes;
+
+  std::vector<LKTrigram> expected(trigrams.size());
+  rlx::seqalgo::bucket_sort(begin(trigrams),end(trigrams),begin(expected),key,direct_sizes);
+  std::vector<LKTrigram> actual(trigrams.size());
+  rlx::seqalgo::buffered_bucket_sort(begin(trigrams),end(trigrams),begin(actual),key,bucket_sizes,
+      &alphabet_type::bucket_index);
+  BOOST_CHECK(actual == expected);
+  BOOST_CHECK(bucket_sizes == direct_sizes);
+
+  /* Automatic selection: both kernels give the same result. */
+  std::vector<LKTrigram> automatic(trigrams.size());
+  auto auto_sizes = rlx::alphabet_tools::make_freq_table(
+      begin(trigrams),end(trigrams),key,alphabet);
+  alphabet_type::make_cumulative(auto_sizes);
+  rlx::seqalgo::auto_bucket_sort<alphabet_type,It,It>(
+      begin(trigrams),end(trigrams),begin(automatic),key,auto_sizes);
+  BOOST_CHECK(automatic == expected);
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_compact_alphabet_test)
+{
+  using rlx::alphabet_tools::compact_alphabet;
+
+  /* Narrow characters: Ranks use the unsigned character type. */
+  const std::string input { "mississippi river" };
+  auto compacted = compact_alphabet<LPos>(begin(input),end(input),4);
+  static_assert(std::is_same<decltype(compacted.first),std::vector<unsigned char>>::value,
+      "Compacted 8-bit text must use 8-bit characters");
+  BOOST_CHECK(compacted.second._highest == 8);
+  const std::vector<unsigned char> expected
+  { 3,2,6,6,2,6,6,2,4,4,2,0,5,2,7,1,5 };
+  BOOST_CHECK(compacted.first == expected);
+
+  /* Wide characters, in parallel, with all 256 values of a narrow
+   * character type. */
+  constexpr std::size_t N = 1024 * 1024;
+  std::vector<unsigned> wide_input(N);
+  for (std::size_t i = 0 ; i < N ; ++i)
+    wide_input[i] = static_cast<unsigned>((i % 256) * 1000003u);
+  auto wide_compacted = compact_alphabet<LPos>(begin(wide_input),end(wide_input),4);
+  BOOST_CHECK(wide_compacted.second._highest == 256);
+  BOOST_CHECK(wide_compacted.first.size() == N);
+  bool ranks_ok
+  { true };
+  for (std::size_t i = 0 ; i < N ; ++i)
+    ranks_ok = ranks_ok && (wide_compacted.first[i] == i % 256);
+  BOOST_CHECK(ranks_ok);
+
+  std::vector<Char> full_input(N);
+  for (std::size_t i = 0 ; i < N ; ++i)
+    full_input[i] = static_cast<Char>(255 - i % 256);
+  auto full_compacted = compact_alphabet<LPos>(begin(full_input),end(full_input),4);
+  BOOST_CHECK(full_compacted.second._highest == 256);
+  BOOST_CHECK(full_compacted.first == full_input);
 }
 
 BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test1)
@@ -175,6 +419,112 @@ BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test1)
       && (equal(begin(actual),end(actual),begin(expected)))));
 }
 
+BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test_multidigit)
+{
+  using rlx::Alphabet;
+  using rlx::AlphabetClass;
+
+  typedef sux::TrigramSorter<LPos,LPos>                       sorter;
+  typedef sux::TrigramMaker<sux::TGImpl::arraytuple,LPos,LPos> maker;
+  typedef typename maker::trigram_type                        trigram;
+
+  /* Digit selection. */
+  BOOST_CHECK((sorter::radix_digits(256) == std::make_pair(1u,8u)));
+  BOOST_CHECK((sorter::radix_digits(1 << 16) == std::make_pair(1u,16u)));
+  BOOST_CHECK((sorter::radix_digits((1 << 16) + 1) == std::make_pair(2u,9u)));
+  BOOST_CHECK((sorter::radix_digits(1 << 20) == std::make_pair(2u,10u)));
+  BOOST_CHECK((sorter::radix_digits(std::size_t(1) << 40) == std::make_pair(3u,14u)));
+
+  /* A text over an alphabet of a million characters, e.g. the
+   * lexicographical names of a recursion level. */
+  constexpr std::size_t N = 1024 * 1024;
+  constexpr std::size_t sigma = 1000000;
+  std::vector<LPos> input(N);
+  std::generate_n(begin(input),N,
+      rlxutil::RandomSequenceGeneratorUniform<LPos>(0,sigma-1));
+
+  auto actual = maker::make_23trigrams(begin(input),end(input),4);
+  std::vector<trigram> expected
+  { actual };
+
+  Alphabet<AlphabetClass::zero_range,LPos,LPos> alphabet
+  { sigma };
+  sux::sort_23trigrams(actual,alphabet,4);
+  std::stable_sort(begin(expected),end(expected),
+      [](const trigram &tri1, const trigram &tri2) {
+        return (std::make_tuple(sux::triget1(tri1),sux::triget2(tri1),sux::triget3(tri1))
+            < std::make_tuple(sux::triget1(tri2),sux::triget2(tri2),sux::triget3(tri2)));
+      });
+  BOOST_CHECK(equal(begin(actual),end(actual),begin(expected)));
+}
+
+/**
+ * The in-place sort does not preserve the order of identical
+ * trigrams. Compare its result to the stably sorted reference
+ * after ordering each run of identical trigrams by position.
+ */
+template <typename TextIt, typename Trigram>
+void check_inplace_sort_result(
+    TextIt text, std::vector<Trigram> &actual, const std::vector<Trigram> &expected)
+{
+  using sux::trigram_tools::pos_of;
+
+  BOOST_CHECK(actual.size() == expected.size());
+  auto run = begin(actual);
+  while (run != end(actual))
+    {
+      auto run_end = find_if(run,end(actual),
+          [&run](const Trigram &tri) { return !tri.content_equal(*run); });
+      sort(run,run_end,[text](const Trigram &tri1, const Trigram &tri2)
+          { return (pos_of(text,tri1) < pos_of(text,tri2)); });
+      run = run_end;
+    }
+  BOOST_CHECK((actual.size() == expected.size()
+      && equal(begin(actual),end(actual),begin(expected),
+          [text](const Trigram &tri1, const Trigram &tri2)
+          { return (tri1.content_equal(tri2) && pos_of(text,tri1) == pos_of(text,tri2)); })));
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test_inplace)
+{
+  using rlx::Alphabet;
+  using rlx::AlphabetClass;
+  using sux::SortPolicy;
+
+  /* Distinct trigrams. */
+  const std::basic_string<Char> input1 { (const Char *)"aecabfgc" };
+  auto expected1 = SAMaker::make_23trigrams(begin(input1),end(input1));
+  auto actual1 = expected1;
+  Alphabet<AlphabetClass::sparse,Char,Pos> alphabet1
+  { };
+  SSorter::sort_23trigrams(expected1,alphabet1,1);
+  SSorter::sort_23trigrams<SortPolicy::msd_inplace>(actual1,alphabet1,1);
+  BOOST_CHECK(equal(begin(actual1),end(actual1),begin(expected1)));
+
+  /* Many repetitions, using a sparse and a (comparatively large)
+   * zero-range alphabet. */
+  constexpr std::size_t N = 1024 * 1024;
+  std::basic_string<Char> input;
+  input.resize(N);
+  std::generate_n(begin(input),N,
+      rlxutil::RandomSequenceGeneratorUniform<Char>('a','f'));
+
+  auto expected = LAMaker::make_23trigrams(begin(input),end(input),4);
+  Alphabet<AlphabetClass::sparse,Char,LPos> sparse_alphabet
+  { };
+  sux::sort_23trigrams(expected,sparse_alphabet,4);
+
+  auto actual = LAMaker::make_23trigrams(begin(input),end(input),4);
+  sux::sort_23trigrams<SortPolicy::msd_inplace>(actual,sparse_alphabet,4);
+  check_inplace_sort_result(begin(input),actual,expected);
+
+  actual = LAMaker::make_23trigrams(begin(input),end(input),4);
+  Alphabet<AlphabetClass::zero_range,Char,LPos> range_alphabet
+  { 255 };
+  sux::sort_23trigrams<SortPolicy::msd_inplace>(actual,range_alphabet,4);
+  check_inplace_sort_result(begin(input),actual,expected);
+}
+
 /**
  * Auxiliary function that performs trigram creation and sorting
  * for a relatively large string and measures time. It also
@@ -206,9 +556,11 @@ void perform_multi_threaded_trigram_sorting()
   typedef typename TrigramMaker::trigram_type     Trigram;
 
   auto actual = TrigramMaker::make_23trigrams(begin(input),end(input));
-  /* Make a copy of the trigrams, which will later be sorted them separately. */
+  /* Make copies of the trigrams, which will later be sorted separately. */
   std::vector<Trigram> expected
   { actual };
+  std::vector<Trigram> inplace
+  { actual };
 
   /* Trigam sort. */
   auto tp1 = rlxutil::combined_clock<std::micro>::now();
@@ -228,19 +580,27 @@ void perform_multi_threaded_trigram_sorting()
                       && (sux::triget3(tri1) < sux::triget3(tri2))));
     });
   auto tp4 = rlxutil::combined_clock<std::micro>::now();
-
-  auto duration_radix  = tp2 - tp1;
-  auto duration_stable = tp4 - tp3;
+  /* In-place MSD radix sort. */
+  auto tp5 = rlxutil::combined_clock<std::micro>::now();
+  sort_23trigrams<sux::SortPolicy::msd_inplace>(inplace,alphabet,4);
+  auto tp6 = rlxutil::combined_clock<std::micro>::now();
+
+  auto duration_radix   = tp2 - tp1;
+  auto duration_stable  = tp4 - tp3;
+  auto duration_inplace = tp6 - tp5;
   /* Print time measurements. */
   cout << setw(18) << "Total trigrams:" << setw(10)
       << distance(begin(expected),end(expected)) << '\n'
       << setw(18) << "Radix sort:" << setw(10)
       << chrono::duration_cast<MS>(duration_radix) << '\n'
+      << setw(18) << "In-place radix:" << setw(10)
+      << chrono::duration_cast<MS>(duration_inplace) << '\n'
       << setw(18) << "Stable sort:" << setw(10)
       << chrono::duration_cast<MS>(duration_stable) << endl;
 
   /* Check for equality of the two results. */
   BOOST_CHECK(equal(begin(actual),end(actual),begin(expected)));
+  check_inplace_sort_result(begin(input),inplace,expected);
 }
 
 BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test_tuple)
@@ -258,6 +618,125 @@ BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test_pointer)
   perform_multi_threaded_trigram_sorting<sux::TGImpl::pointer>();
 }
 
+BOOST_AUTO_TEST_CASE(sux_builder_sort_23trigrams_test_packed)
+{
+  perform_multi_threaded_trigram_sorting<sux::TGImpl::packed>();
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_sort_23positions_test)
+{
+  using rlx::Alphabet;
+  using rlx::AlphabetClass;
+
+  constexpr std::size_t N = 4 * 1024 * 1024;
+  std::basic_string<Char> input;
+  input.resize(N);
+  std::generate_n(begin(input),N,
+      rlxutil::RandomSequenceGeneratorUniform<Char>('a','d'));
+
+  Alphabet<AlphabetClass::sparse,Char,LPos> alphabet
+  { };
+
+  /* Reference: Sorting the pointer trigrams themselves. */
+  auto expected = LPMaker::make_23trigrams(begin(input),end(input),4);
+  sux::sort_23trigrams(expected,alphabet,4);
+
+  /* Index-based sort, followed by materialisation of the trigrams. */
+  auto positions = sux::sort_23positions<LPos>(begin(input),end(input),alphabet,4);
+  BOOST_CHECK(positions.size() == expected.size());
+  auto actual = LPMaker::from_positions(begin(input),positions,4);
+  BOOST_CHECK((actual.size() == expected.size()
+      && (equal(begin(actual),end(actual),begin(expected),
+          [](const LPTrigram &t1, const LPTrigram &t2) { return (t1._p == t2._p); }))));
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_qgram_test)
+{
+  typedef sux::QGramMaker<5,Char,LPos> maker;
+  typedef maker::qgram_type            qgram;
+
+  const std::basic_string<Char> input { (const Char *)"abcabcab" };
+  auto actual = maker::make_qgrams(begin(input),end(input),3);
+  std::vector<qgram> expected
+  {
+    qgram { 0 , {{ 'a','b','c','a','b' }} },
+    qgram { 1 , {{ 'b','c','a','b','c' }} },
+    qgram { 2 , {{ 'c','a','b','c','a' }} },
+    qgram { 3 , {{ 'a','b','c','a','b' }} }
+  };
+  BOOST_CHECK(actual == expected);
+  BOOST_CHECK(sux::qget<4>(actual[1]) == 'c');
+  BOOST_CHECK(maker::make_qgrams(begin(input),begin(input) + 4).empty());
+
+  /* Characters per radix digit. */
+  BOOST_CHECK((sux::QGramSorter<5,Char,LPos>::chars_per_digit(4) == 5));
+  BOOST_CHECK((sux::QGramSorter<9,Char,LPos>::chars_per_digit(4) == 8));
+  BOOST_CHECK((sux::QGramSorter<9,Char,LPos>::chars_per_digit(5) == 5));
+  BOOST_CHECK((sux::QGramSorter<9,Char,LPos>::chars_per_digit(256) == 2));
+  BOOST_CHECK((sux::QGramSorter<9,LPos,LPos>::chars_per_digit(1 << 20) == 1));
+}
+
+/**
+ * Sort the q-grams of a random text over `sigma` characters, and
+ * compare to a stable comparison sort.
+ */
+template <unsigned Q, typename AlphabetType>
+void check_qgram_sort(std::size_t sigma, const AlphabetType &alphabet)
+{
+  typedef sux::QGramMaker<Q,Char,LPos>  maker;
+  typedef sux::QGramSorter<Q,Char,LPos> sorter;
+  typedef typename maker::qgram_type    qgram;
+
+  constexpr std::size_t N = 1024 * 1024;
+  std::basic_string<Char> input;
+  input.resize(N);
+  std::generate_n(begin(input),N,
+      rlxutil::RandomSequenceGeneratorUniform<Char>(0,static_cast<Char>(sigma - 1)));
+
+  auto actual = maker::make_qgrams(begin(input),end(input),4);
+  std::vector<qgram> expected
+  { actual };
+  sorter::sort_qgrams(actual,alphabet,4);
+  std::stable_sort(begin(expected),end(expected),
+      [](const qgram &q1, const qgram &q2) { return (q1._chars < q2._chars); });
+  BOOST_CHECK(actual == expected);
+
+  /* Index-based sort. */
+  std::vector<LPos> positions(expected.size());
+  for (std::size_t pos = 0 ; pos < positions.size() ; ++pos)
+    positions[pos] = static_cast<LPos>(positions.size() - 1 - pos);
+  std::reverse(begin(expected),end(expected));
+  sorter::sort_positions(positions,input,alphabet,4);
+  std::stable_sort(begin(expected),end(expected),
+      [](const qgram &q1, const qgram &q2) { return (q1._chars < q2._chars); });
+  BOOST_CHECK((positions.size() == expected.size()
+      && equal(begin(positions),end(positions),begin(expected),
+          [](LPos pos, const qgram &q) { return (pos == q.pos()); })));
+
+  /* Statistics. */
+  auto freqs = sux::qgram_tools::frequencies(actual);
+  std::size_t total
+  { 0 };
+  for (const auto &freq : freqs)
+    total += freq.second;
+  BOOST_CHECK(total == actual.size());
+  BOOST_CHECK(std::adjacent_find(begin(freqs),end(freqs),
+      [](const std::pair<qgram,std::size_t> &f1, const std::pair<qgram,std::size_t> &f2)
+      { return !(f1.first._chars < f2.first._chars); }) == end(freqs));
+}
+
+BOOST_AUTO_TEST_CASE(sux_builder_sort_qgrams_test)
+{
+  using rlx::Alphabet;
+  using rlx::AlphabetClass;
+
+  /* Packed digits: five characters per pass, or two. */
+  check_qgram_sort<7>(4,Alphabet<AlphabetClass::zero_range,Char,LPos> { 4 });
+  check_qgram_sort<13>(256,Alphabet<AlphabetClass::zero_range,Char,LPos> { 256 });
+  /* One pass per character. */
+  check_qgram_sort<6>(26,Alphabet<AlphabetClass::sparse,Char,LPos> { });
+}
+
 template <sux::TGImpl tgimpl>
 std::vector<typename sux::TrigramMaker<tgimpl,char,Pos>::trigram_type>
 make_boundary_adjustment_testinput()
@@ -350,4 +829,5 @@ BOOST_AUTO_TEST_CASE(sux_builder_boundary_adjustment)
   perform_boundary_adjustment_test<sux::TGImpl::tuple>();
   perform_boundary_adjustment_test<sux::TGImpl::arraytuple>();
   perform_boundary_adjustment_test<sux::TGImpl::pointer>();
+  perform_boundary_adjustment_test<sux::TGImpl::packed>();
 }
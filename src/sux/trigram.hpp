@@ -13,6 +13,7 @@
 #include <array>
 #include <vector>
 #include <algorithm>
+#include <cassert>
 #include <iterator>
 #include <map>
 #include <future>
@@ -21,6 +22,11 @@
 #include <ios>
 #include <thread>
 #include <chrono>
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 #include "alphabet.hpp"
 #include "../util/parallelization.hpp"
@@ -29,7 +35,7 @@
 namespace sux {
 
   /** Implementation of trigrams. */
-  enum class TGImpl { tuple, arraytuple, structure, pointer };
+  enum class TGImpl { tuple, arraytuple, structure, pointer, packed };
 
   /** String representation of trigram implementation types. */
   template <TGImpl tgimpl> struct repr;
@@ -37,6 +43,7 @@ namespace sux {
   template <> struct repr<TGImpl::arraytuple> { static constexpr const char *str = "arraytuple"; };
   template <> struct repr<TGImpl::structure>  { static constexpr const char *str = "structure"; };
   template <> struct repr<TGImpl::pointer>    { static constexpr const char *str = "pointer"; };
+  template <> struct repr<TGImpl::packed>     { static constexpr const char *str = "packed"; };
 
   template <TGImpl tgimpl, typename Char, typename Pos>
   struct TrigramImpl;
@@ -130,8 +137,125 @@ namespace sux {
     { return ((get1() == other.get1()) && (get2() == other.get2() && (get3() == other.get3()))); }
   };
 
+  /**
+   * Bit layout of packed trigrams. The three characters occupy the
+   * highest bits of the word, the position the lowest. For 8-bit
+   * characters, a 64-bit word is used, which leaves 40 bits for the
+   * position. For wider characters, a 128-bit word is used.
+   */
+  template <typename Char, typename Pos>
+  struct PackedLayout
+  {
+    static constexpr unsigned char_bits = sizeof(Char) * CHAR_BIT;
+
+    static_assert(3 * char_bits + 32 <= 128,
+        "Packed trigrams require a character type of at most 32 bits");
+
+    typedef typename std::conditional<(3 * char_bits + 32 <= 64),
+        std::uint64_t,unsigned __int128>::type                     word_type;
+    typedef typename std::make_unsigned<Char>::type                uchar_type;
+
+    static constexpr unsigned word_bits = sizeof(word_type) * CHAR_BIT;
+    static constexpr unsigned pos_bits  =
+        (word_bits - 3 * char_bits < sizeof(Pos) * CHAR_BIT ?
+            word_bits - 3 * char_bits : sizeof(Pos) * CHAR_BIT);
+
+    /** Added (modulo 2^char_bits) to signed characters, so that the
+     * unsigned representation has the same order as the characters. */
+    static constexpr uchar_type char_flip =
+        (std::is_signed<Char>::value ?
+            static_cast<uchar_type>(uchar_type(1) << (char_bits - 1)) : uchar_type(0));
+
+    static constexpr word_type pos_mask  =
+        (pos_bits == word_bits ? ~word_type(0) : ((word_type(1) << pos_bits) - 1));
+    static constexpr word_type char_mask =
+        ((word_type(1) << char_bits) - 1);
+
+    static constexpr word_type encode(const Char c)
+    { return static_cast<word_type>(static_cast<uchar_type>(static_cast<uchar_type>(c) ^ char_flip)); }
+
+    static constexpr Char decode(const word_type w)
+    { return static_cast<Char>(static_cast<uchar_type>(static_cast<uchar_type>(w & char_mask) ^ char_flip)); }
+  };
+
+  /**
+   * Packed implementation of trigrams: The three characters and the
+   * position are stored in one integer word (see `PackedLayout`). The
+   * characters make up the highest bits of the word, so comparing the
+   * `key()` of two trigrams compares their character strings.
+   */
+  template <typename Char, typename Pos>
+  struct TrigramImpl<TGImpl::packed,Char,Pos>
+  {
+    typedef PackedLayout<Char,Pos>         layout;
+    typedef typename layout::word_type     word_type;
+    typedef Char                           char_type;
+    typedef Pos                            pos_type;
+    typedef std::vector<TrigramImpl>       vec_type;
+    constexpr static TGImpl                impl = TGImpl::packed;
+
+    word_type _word;
+
+    TrigramImpl()
+    : _word()
+    { }
+
+    TrigramImpl(
+        const Pos pos,
+        const Char c1,
+        const Char c2,
+        const Char c3)
+    : _word((layout::encode(c1) << (layout::pos_bits + 2 * layout::char_bits))
+        | (layout::encode(c2) << (layout::pos_bits + layout::char_bits))
+        | (layout::encode(c3) << layout::pos_bits)
+        | (static_cast<word_type>(pos) & layout::pos_mask))
+    { }
+
+    pos_type  pos() const  { return static_cast<pos_type>(_word & layout::pos_mask); }
+    char_type get1() const { return layout::decode(_word >> (layout::pos_bits + 2 * layout::char_bits)); }
+    char_type get2() const { return layout::decode(_word >> (layout::pos_bits + layout::char_bits)); }
+    char_type get3() const { return layout::decode(_word >> layout::pos_bits); }
+
+    /** The three characters as one integer. */
+    word_type key() const  { return (_word >> layout::pos_bits); }
+
+    bool operator==(const TrigramImpl &other) const
+    { return (_word == other._word); }
+
+    bool content_equal(const TrigramImpl &other) const
+    { return (key() == other.key()); }
+  };
+
   namespace trigram_tools {
 
+    /**
+     * The largest text position a trigram type can represent.
+     */
+    template <typename TrigramT, typename = void>
+    struct pos_limit
+    {
+      static constexpr std::uintmax_t value =
+          std::numeric_limits<typename TrigramT::pos_type>::max();
+    };
+
+    /** Plain positions, as used by index-based sorting. */
+    template <typename Pos>
+    struct pos_limit<Pos,typename std::enable_if<std::is_integral<Pos>::value>::type>
+    {
+      static constexpr std::uintmax_t value =
+          std::numeric_limits<Pos>::max();
+    };
+
+    template <typename Char, typename Pos>
+    struct pos_limit<TrigramImpl<TGImpl::packed,Char,Pos>,void>
+    {
+      typedef PackedLayout<Char,Pos> layout;
+      static constexpr std::uintmax_t value =
+          (layout::pos_bits >= sizeof(std::uintmax_t) * CHAR_BIT ?
+              std::numeric_limits<std::uintmax_t>::max() :
+              ((std::uintmax_t(1) << layout::pos_bits) - 1));
+    };
+
     /**
      * Compare the character strings of two trigrams.
      */
@@ -174,6 +298,17 @@ namespace sux {
       { return trigram.pos(); }
     };
 
+    template <typename Char, typename Pos>
+    struct posmapper<TGImpl::packed,Char,Pos>
+    {
+      static Pos pos_of(const TrigramImpl<TGImpl::packed,Char,Pos> &trigram)
+      { return trigram.pos(); }
+
+      template <typename It>
+      static Pos pos_of(It, const TrigramImpl<TGImpl::packed,Char,Pos> &trigram)
+      { return trigram.pos(); }
+    };
+
     template <typename Char, typename Pos>
     struct posmapper<TGImpl::pointer,Char,Pos>
     {
@@ -232,11 +367,94 @@ namespace sux {
   template <typename TrigramT> struct TrigramContainer
   { typedef std::vector<TrigramT> vec_type; };
 
+  namespace trigram_tools {
+
+    /**
+     * The number of 2,3-trigrams (i.e. complete trigrams starting at
+     * positions not divisible by 3) of a text of the given length.
+     */
+    constexpr std::size_t num_23trigrams(std::size_t length)
+    { return (length < 3 ? 0 : (length - 2) - (length - 2 + 2) / 3); }
+
+    /**
+     * The index of the trigram starting at text position `pos` (where
+     * `pos % 3 != 0`) in the list of 2,3-trigrams of the text.
+     */
+    constexpr std::size_t index_of_23trigram(std::size_t pos)
+    { return 2 * (pos / 3) + (pos % 3) - 1; }
+
+    /**
+     * Generate the 2,3-trigrams of the text [from,to) using parallel
+     * threads. The result vector is allocated with its final size up
+     * front. The text is cut into portions that begin at positions
+     * divisible by 3, so each thread knows where in the result vector
+     * its trigrams go and fills that slice in place. `Maker` must
+     * provide a static function `make_at(it,pos)` that creates the
+     * trigram starting at iterator `it`, i.e. at text position `pos`.
+     */
+    template <typename Maker, typename Iterator>
+    typename Maker::trigram_vec_type
+    make_23trigrams_parallel(Iterator from, Iterator to, unsigned threads)
+    {
+      using std::distance;
+      typedef typename Maker::trigram_type           trigram_type;
+      typedef typename Maker::trigram_vec_type       vec_type;
+      typedef typename Maker::pos_type               pos_type;
+      typedef rlxutil::parallel::portions::adjustment adjustment;
+
+      const std::size_t length
+      { static_cast<std::size_t>(distance(from,to)) };
+      if (static_cast<std::uintmax_t>(length) > pos_limit<trigram_type>::value)
+        throw std::out_of_range("Attempt to generate trigrams for a text that is "
+            "too long for the position range of the trigram implementation");
+
+      vec_type result(num_23trigrams(length));
+      if (result.empty())
+        return result;
+
+      /* Trigrams start at positions [0,length-2). Each portion
+       * must start at a position divisible by 3. */
+      const Iterator last
+      { std::next(from,length - 2) };
+      rlxutil::parallel::portions portions
+      { from , last , threads ,
+        [](Iterator beg, Iterator loc, Iterator /*end*/)
+        { return ((distance(beg,loc) + 1) % 3 != 0 ? adjustment::needed : adjustment::unneeded); }
+      };
+
+      auto futs =
+          portions.apply(from,last,
+              [from,&result](Iterator local_from, Iterator local_to)
+              {
+                pos_type pos
+                { static_cast<pos_type>(distance(from,local_from)) };
+                const pos_type end
+                { static_cast<pos_type>(distance(from,local_to)) };
+                auto out = result.begin() + index_of_23trigram(pos + 1);
+                for ( ; pos < end ; pos += 3)
+                  {
+                    /* Position 0, skip. Positions 1 and 2, copy. */
+                    if (pos + 1 < end)
+                      *(out++) = Maker::make_at(std::next(local_from,1),pos + 1);
+                    if (pos + 2 < end)
+                      *(out++) = Maker::make_at(std::next(local_from,2),pos + 2);
+                    if (pos + 3 < end)
+                      std::advance(local_from,3);
+                  }
+              });
+
+      rlxutil::parallel::tools::wait_for(futs);
+      return result;
+    }
+
+  }
+
   template <TGImpl tgimpl, typename Char, typename Pos>
   struct TrigramMaker
   {
     typedef TrigramImpl<tgimpl,Char,Pos>                      trigram_type;
     typedef typename TrigramContainer<trigram_type>::vec_type trigram_vec_type;
+    typedef Pos                                               pos_type;
 
     /**
      * Generate a list of trigrams starting at positions not divisible by 3.
@@ -246,8 +464,14 @@ namespace sux {
     template <typename Iterator>
     static trigram_vec_type make_23trigrams(Iterator from, Iterator to)
     {
-      short pos { 0 };
+      if (static_cast<std::uintmax_t>(std::distance(from,to))
+          > trigram_tools::pos_limit<trigram_type>::value)
+        throw std::out_of_range("Attempt to generate trigrams for a text that is "
+            "too long for the position range of the trigram implementation");
+
+      Pos pos { 0 };
       trigram_vec_type result;
+      result.reserve(trigram_tools::num_23trigrams(std::distance(from,to)));
       while (std::distance(from,to) >= 5)
       {
         /* Position 0, skip. */
@@ -283,6 +507,54 @@ namespace sux {
       return result;
     }
 
+    /**
+     * Parallel version of `make_23trigrams(from,to)`, using the given
+     * number of threads. The iterators must be random-access iterators.
+     */
+    template <typename Iterator>
+    static trigram_vec_type make_23trigrams(Iterator from, Iterator to, unsigned threads)
+    { return trigram_tools::make_23trigrams_parallel<TrigramMaker>(from,to,threads); }
+
+    /**
+     * Create the trigram that starts at text position `pos`, which
+     * `it` points to.
+     */
+    template <typename Iterator>
+    static trigram_type make_at(Iterator it, Pos pos)
+    { return trigram_type(pos,*it,*std::next(it,1),*std::next(it,2)); }
+
+    /**
+     * Create the trigrams for a list of text positions, e.g. as
+     * produced by `TrigramSorter::sort_23positions()`, using parallel
+     * threads. The trigrams are in the order of the positions.
+     */
+    template <typename Iterator, typename PosVector>
+    static trigram_vec_type from_positions(
+        Iterator text_from, const PosVector &positions, unsigned threads)
+    {
+      typedef typename PosVector::const_iterator pos_it;
+
+      trigram_vec_type result(positions.size());
+      if (result.empty())
+        return result;
+
+      rlxutil::parallel::portions portions
+      { positions.begin() , positions.end() , threads };
+      auto futs =
+          portions.apply(positions.begin(),positions.end(),
+              [&positions,&result,text_from](pos_it from, pos_it to)
+              {
+                auto out = result.begin() + std::distance(positions.begin(),from);
+                while (from != to)
+                  {
+                    *(out++) = make_at(std::next(text_from,*from),*from);
+                    ++from;
+                  }
+              });
+      rlxutil::parallel::tools::wait_for(futs);
+      return result;
+    }
+
   };
 
   template <typename Char, typename Pos>
@@ -290,6 +562,7 @@ namespace sux {
   {
     typedef TrigramImpl<TGImpl::pointer,Char,Pos>             trigram_type;
     typedef typename TrigramContainer<trigram_type>::vec_type trigram_vec_type;
+    typedef Pos                                               pos_type;
 
     /**
      * Generate a list of trigrams starting at positions not divisible by 3.
@@ -300,6 +573,7 @@ namespace sux {
     static trigram_vec_type make_23trigrams(Iterator from, Iterator to)
     {
       trigram_vec_type result;
+      result.reserve(trigram_tools::num_23trigrams(std::distance(from,to)));
       while (std::distance(from,to) >= 5)
       {
         /* Position 0, skip. */
@@ -325,8 +599,92 @@ namespace sux {
       return result;
     }
 
+    /**
+     * Parallel version of `make_23trigrams(from,to)`, using the given
+     * number of threads. The iterators must be random-access iterators.
+     */
+    template <typename Iterator>
+    static trigram_vec_type make_23trigrams(Iterator from, Iterator to, unsigned threads)
+    { return trigram_tools::make_23trigrams_parallel<TrigramMaker>(from,to,threads); }
+
+    /**
+     * Create the trigram that starts at `it`.
+     */
+    template <typename Iterator>
+    static trigram_type make_at(Iterator it, Pos)
+    { return trigram_type(&*it); }
+
+    /**
+     * Create the trigrams for a list of text positions, e.g. as
+     * produced by `TrigramSorter::sort_23positions()`, using parallel
+     * threads. The trigrams are in the order of the positions.
+     */
+    template <typename Iterator, typename PosVector>
+    static trigram_vec_type from_positions(
+        Iterator text_from, const PosVector &positions, unsigned threads)
+    {
+      typedef typename PosVector::const_iterator pos_it;
+
+      trigram_vec_type result(positions.size());
+      if (result.empty())
+        return result;
+
+      rlxutil::parallel::portions portions
+      { positions.begin() , positions.end() , threads };
+      auto futs =
+          portions.apply(positions.begin(),positions.end(),
+              [&positions,&result,text_from](pos_it from, pos_it to)
+              {
+                auto out = result.begin() + std::distance(positions.begin(),from);
+                while (from != to)
+                  {
+                    *(out++) = make_at(std::next(text_from,*from),*from);
+                    ++from;
+                  }
+              });
+      rlxutil::parallel::tools::wait_for(futs);
+      return result;
+    }
+
+  };
+
+  /**
+   * Generates plain text positions instead of trigrams. This is used
+   * for index-based sorting, where the characters of each trigram are
+   * read from the text whenever they are needed.
+   */
+  template <typename Pos>
+  struct PositionMaker
+  {
+    typedef Pos              trigram_type;
+    typedef std::vector<Pos> trigram_vec_type;
+    typedef Pos              pos_type;
+
+    /**
+     * Generate the list of positions not divisible by 3 that start a
+     * complete trigram, using the given number of parallel threads.
+     */
+    template <typename Iterator>
+    static trigram_vec_type make_23positions(Iterator from, Iterator to, unsigned threads)
+    { return trigram_tools::make_23trigrams_parallel<PositionMaker>(from,to,threads); }
+
+    template <typename Iterator>
+    static Pos make_at(Iterator, Pos pos)
+    { return pos; }
   };
 
+  /**
+   * Radix-sort strategies for trigram sorting:
+   *   lsd          Three stable passes of least-significant-digit radix
+   *                sort. Requires a second vector of the same size as the
+   *                input.
+   *   msd_inplace  Most-significant-digit radix sort that permutes the
+   *                buckets in place ("American flag sort"). Needs no second
+   *                vector, but the relative order of identical trigrams is
+   *                unspecified.
+   */
+  enum class SortPolicy { lsd, msd_inplace };
+
   /**
    * Lexicographic sorting of trigrams, using one or multiple threads.
    */
@@ -343,12 +701,12 @@ namespace sux {
      * before the call. bucket_sizes must be prepared by the caller so it
      * provides the size of each bucket.
      */
-    template <typename Iterator, typename CharExtractor>
+    template <typename Iterator, typename CharExtractor, typename FreqTable = CharDistribution>
     static void bucket_sort(
         Iterator           from,
         Iterator           to,
         CharExtractor      extractor,
-        CharDistribution  &bucket_sizes,
+        FreqTable         &bucket_sizes,
         Iterator           dest)
     {
       while (from != to)
@@ -384,72 +742,382 @@ namespace sux {
           (from,to,make_freq_table<It,Extractor,AlphabetType>,
               extractor,alphabet);
 
-      /* Initialise cumulative frequencies per thread. This will
-       * be filled with the correct values later. */
+      /* Move the thread-local frequency tables out of their
+       * futures. */
       std::vector<freq_table_type> cumul_frqtab_vec
       { };
-
-      /* Total frequency, for each character. */
-      freq_table_type cumul_frqtab
-      { };
       for (auto &frqtab_fut : frqtab_vec)
-      {
-        /* Move the thread-local frequency table out
-         * of its future. */
-        freq_table_type frqtab
-        { frqtab_fut.get() };
-        /* Add its character frequencies to the total table. */
-        AlphabetType::add_char_freq_table(cumul_frqtab,frqtab,portions.num());
-        /* Move thread-local frequency table to the end of the
-         * thread-local cumulative frequency table list. Note
-         * that the frequencies are not really cumulative yet;
-         * this will be corrected later. */
-        cumul_frqtab_vec.push_back(std::move(frqtab));
-      }
-
-      /* Cumulate the entries of the global frequency table. */
-      AlphabetType::make_cumulative(cumul_frqtab);
+        cumul_frqtab_vec.push_back(frqtab_fut.get());
 
-      /* Correct the cumulative thread-local frequencies. */
-      for (freq_table_type &frqtab : cumul_frqtab_vec) {
-        /* Swap with current version of global cumulative
-         * frequency table. */
-        std::swap(cumul_frqtab,frqtab);
-        AlphabetType::add_char_freq_table(cumul_frqtab,frqtab,portions.num());
-      }
+      /* Turn them into thread-local cumulative frequencies, i.e. the
+       * position where each thread writes the next element of each
+       * bucket. */
+      AlphabetType::make_cumulative(cumul_frqtab_vec,portions.threads());
 
       /* Radix-sorting threads. */
       auto sort_fut_vec = portions.apply_dynargs
-          (from,to,bucket_sort<It,Extractor>,
+          (from,to,rlx::seqalgo::auto_bucket_sort<AlphabetType,It,It,Extractor>,
            arg_generator(
                [&cumul_frqtab_vec,dest,&extractor](int thread)
-               { return make_tuple(extractor,ref(cumul_frqtab_vec[thread]),dest); })
+               { return make_tuple(dest,extractor,ref(cumul_frqtab_vec[thread])); })
           );
 
       wait_for(sort_fut_vec);
     }
 
-    template <typename TrigramType, typename AlphabetType>
+    /**
+     * Zero-range alphabets larger than this many characters are sorted
+     * by several radix passes per character, each using a digit of at
+     * most `max_digit_bits` bits.
+     */
+    static constexpr unsigned max_digit_bits = 16;
+
+    /**
+     * Determine how to split the characters of a zero-range alphabet
+     * of `highest` characters into digits.
+     * @return The number of digits and the number of bits per digit.
+     */
+    static std::pair<unsigned,unsigned> radix_digits(std::size_t highest)
+    {
+      unsigned bits
+      { 0 };
+      while ((bits < sizeof(std::size_t) * CHAR_BIT) && ((highest - 1) >> bits) != 0)
+        ++bits;
+      if (bits <= max_digit_bits)
+        return { 1 , bits };
+      const unsigned num_digits
+      { (bits + max_digit_bits - 1) / max_digit_bits };
+      return { num_digits , (bits + num_digits - 1) / num_digits };
+    }
+
+    /**
+     * Perform a stable radix pass that sorts `data` by the character
+     * returned by `extractor`, using `temp` as intermediate storage.
+     * The result is in `data`.
+     */
+    template <typename Vector, typename Extractor, typename AlphabetType>
+    static void lsd_pass(
+        Vector &data, Vector &temp, Extractor extractor,
+        const AlphabetType &alphabet, const rlxutil::parallel::portions &portions)
+    {
+      parallel_bucket_sort(begin(data),end(data),begin(temp),extractor,alphabet,portions);
+      swap(data,temp);
+    }
+
+    /**
+     * Radix pass for zero-range alphabets. If the alphabet is large
+     * (e.g. the lexicographical names of a recursion level), the
+     * characters are sorted digit by digit, least significant digit
+     * first, so the frequency tables stay small regardless of the
+     * size of the alphabet.
+     */
+    template <typename Vector, typename Extractor, typename AlphaChar, typename Freq>
+    static void lsd_pass(
+        Vector &data, Vector &temp, Extractor extractor,
+        const rlx::Alphabet<rlx::AlphabetClass::zero_range,AlphaChar,Freq> &alphabet,
+        const rlxutil::parallel::portions &portions)
+    {
+      typedef rlx::Alphabet<rlx::AlphabetClass::zero_range,AlphaChar,Freq> alphabet_type;
+      typedef typename Vector::value_type                                   elem_type;
+
+      const std::pair<unsigned,unsigned> digits
+      { radix_digits(alphabet._highest) };
+      if (digits.first == 1)
+        {
+          parallel_bucket_sort(begin(data),end(data),begin(temp),extractor,alphabet,portions);
+          swap(data,temp);
+          return;
+        }
+
+      const alphabet_type digit_alphabet
+      { std::size_t(1) << digits.second };
+      const std::size_t mask
+      { (std::size_t(1) << digits.second) - 1 };
+      for (unsigned digit = 0 ; digit < digits.first ; ++digit)
+        {
+          const unsigned shift
+          { digit * digits.second };
+          parallel_bucket_sort(begin(data),end(data),begin(temp),
+              [extractor,shift,mask](const elem_type &elem)
+              { return static_cast<AlphaChar>((static_cast<std::size_t>(extractor(elem)) >> shift) & mask); },
+              digit_alphabet,portions);
+          swap(data,temp);
+        }
+    }
+
+    template <SortPolicy policy = SortPolicy::lsd,
+              typename TrigramType, typename AlphabetType>
     static void sort_23trigrams(
         std::vector<TrigramType> &trigrams, const AlphabetType &alphabet, unsigned num_threads)
     {
+      if (policy == SortPolicy::msd_inplace)
+        {
+          sort_23trigrams_inplace(begin(trigrams),end(trigrams),alphabet,num_threads);
+          return;
+        }
+
       /* Portions for threads. */
       rlxutil::parallel::portions portions
       { begin(trigrams), end(trigrams), num_threads };
       /* Vector for intermediate results. */
       std::vector<TrigramType> temp_vec(trigrams.size());
       /* First pass. */
-      parallel_bucket_sort(begin(trigrams),end(trigrams),begin(temp_vec),
-          triget3<TrigramType>,alphabet,portions);
-      swap(trigrams,temp_vec);
+      lsd_pass(trigrams,temp_vec,triget3<TrigramType>,alphabet,portions);
       /* Second pass. */
-      parallel_bucket_sort(begin(trigrams),end(trigrams),begin(temp_vec),
-          triget2<TrigramType>,alphabet,portions);
-      swap(trigrams,temp_vec);
+      lsd_pass(trigrams,temp_vec,triget2<TrigramType>,alphabet,portions);
       /* Third pass. */
-      parallel_bucket_sort(begin(trigrams),end(trigrams),begin(temp_vec),
-          triget1<TrigramType>,alphabet,portions);
-      swap(trigrams,temp_vec);
+      lsd_pass(trigrams,temp_vec,triget1<TrigramType>,alphabet,portions);
+    }
+
+    /**
+     * Buckets smaller than this are sorted by comparison rather
+     * than by further radix passes.
+     */
+    static constexpr std::ptrdiff_t msd_small_bucket = 32;
+
+    template <typename TrigramType>
+    static Char trichar(const TrigramType &tri, std::integral_constant<unsigned,0>)
+    { return triget1(tri); }
+    template <typename TrigramType>
+    static Char trichar(const TrigramType &tri, std::integral_constant<unsigned,1>)
+    { return triget2(tri); }
+    template <typename TrigramType>
+    static Char trichar(const TrigramType &tri, std::integral_constant<unsigned,2>)
+    { return triget3(tri); }
+
+    /**
+     * Compare two trigrams by their characters from position
+     * `depth` (0, 1 or 2) onwards.
+     */
+    template <typename TrigramType>
+    static bool less_from(const TrigramType &tri1, const TrigramType &tri2, unsigned depth)
+    {
+      if ((depth < 1) && (triget1(tri1) != triget1(tri2)))
+        return (triget1(tri1) < triget1(tri2));
+      if ((depth < 2) && (triget2(tri1) != triget2(tri2)))
+        return (triget2(tri1) < triget2(tri2));
+      return (triget3(tri1) < triget3(tri2));
+    }
+
+    /**
+     * A bucket of the in-place radix sort: The character shared by
+     * all its elements, and its offsets relative to the beginning of
+     * the range being sorted.
+     */
+    template <typename Diff>
+    struct msd_bucket
+    {
+      Char _char;
+      Diff _begin;
+      Diff _end;
+    };
+
+    /**
+     * Collect the non-empty buckets described by the frequency table,
+     * and permute the elements of [from,to) in place so that each of
+     * them is moved into its bucket.
+     */
+    template <typename It, typename Extractor, typename AlphabetType>
+    static std::vector<msd_bucket<typename std::iterator_traits<It>::difference_type>>
+    permute_into_buckets(
+        It                                          from,
+        It                                          to,
+        Extractor                                   extractor,
+        const typename AlphabetType::freq_table_type &counts)
+    {
+      using std::swap;
+      typedef typename std::iterator_traits<It>::difference_type diff_t;
+      typedef typename AlphabetType::freq_type                   freq_type;
+
+      std::vector<msd_bucket<diff_t>> buckets
+      { };
+      /* The next position to be filled, for each bucket. */
+      typename AlphabetType::freq_table_type heads
+      { counts };
+
+      diff_t offset
+      { 0 };
+      AlphabetType::for_each_char(counts,
+          [&buckets,&heads,&offset](Char c, freq_type freq)
+          {
+            buckets.push_back(msd_bucket<diff_t> { c , offset , offset + static_cast<diff_t>(freq) });
+            heads[c] = static_cast<freq_type>(offset);
+            offset  += static_cast<diff_t>(freq);
+          });
+      assert(offset == std::distance(from,to));
+
+      /* All elements in the same bucket: Nothing to be moved. */
+      if (buckets.size() < 2)
+        return buckets;
+
+      /* Cycle leader permutation: Take the element at the head of
+       * the current bucket and swap it into the bucket it belongs
+       * to, until an element belonging to the current bucket
+       * arrives. The last bucket is complete once all others are. */
+      for (std::size_t b = 0 ; b + 1 < buckets.size() ; ++b)
+        {
+          const Char c
+          { buckets[b]._char };
+          const diff_t end
+          { buckets[b]._end };
+          for (diff_t pos = heads[c] ; pos < end ; pos = ++heads[c])
+            {
+              It it
+              { from + pos };
+              Char k
+              { extractor(*it) };
+              while (k != c)
+                {
+                  swap(*it,*(from + heads[k]++));
+                  k = extractor(*it);
+                }
+            }
+        }
+
+      return buckets;
+    }
+
+    /**
+     * Sort [from,to) by the characters from position `Depth` onwards,
+     * assuming all elements share their first `Depth` characters.
+     * This is sequential; parallelism is applied at the top level only.
+     */
+    template <unsigned Depth, typename It, typename AlphabetType>
+    static void msd_sort(
+        It from, It to, const AlphabetType &alphabet, std::size_t table_size,
+        std::integral_constant<unsigned,Depth> depth)
+    {
+      typedef rlxtype::deref<It>                                 elem_type;
+      typedef typename std::iterator_traits<It>::difference_type diff_t;
+
+      const diff_t len
+      { std::distance(from,to) };
+      if (len < 2)
+        return;
+
+      /* Small buckets are not worth a frequency table. This includes
+       * buckets that are smaller than the (dense) frequency table of
+       * a large alphabet. */
+      if ((len < msd_small_bucket) || (static_cast<std::size_t>(len) < table_size))
+        {
+          std::sort(from,to,[](const elem_type &tri1, const elem_type &tri2)
+              { return less_from(tri1,tri2,Depth); });
+          return;
+        }
+
+      auto extractor = [depth](const elem_type &tri) { return trichar(tri,depth); };
+      auto counts = rlx::alphabet_tools::make_freq_table(from,to,extractor,alphabet);
+      auto buckets = permute_into_buckets<It,decltype(extractor),AlphabetType>(
+          from,to,extractor,counts);
+
+      for (const auto &bucket : buckets)
+        msd_sort(from + bucket._begin,from + bucket._end,alphabet,table_size,
+            std::integral_constant<unsigned,Depth+1>());
+    }
+
+    /**
+     * End of recursion: All three characters have been sorted.
+     */
+    template <typename It, typename AlphabetType>
+    static void msd_sort(
+        It, It, const AlphabetType &, std::size_t, std::integral_constant<unsigned,3>)
+    { }
+
+    /**
+     * Sort the trigrams in [from,to) in place, using most-significant-
+     * digit radix sort. The top-level character frequencies are counted
+     * in parallel, and after the elements have been permuted into their
+     * buckets, the buckets are sorted recursively in parallel (using
+     * work stealing, as bucket sizes may differ widely).
+     */
+    template <typename It, typename AlphabetType>
+    static void sort_23trigrams_inplace(
+        It from, It to, const AlphabetType &alphabet, unsigned num_threads)
+    {
+      using rlx::alphabet_tools::make_freq_table;
+      using rlxutil::parallel::portions;
+      using rlxutil::parallel::tools::wait_for;
+
+      typedef rlxtype::deref<It>                                 elem_type;
+      typedef typename AlphabetType::freq_table_type             freq_table_type;
+      typedef typename std::iterator_traits<It>::difference_type diff_t;
+      typedef msd_bucket<diff_t>                                 bucket_type;
+      typedef typename std::vector<bucket_type>::const_iterator  BucketIt;
+
+      if (std::distance(from,to) < 2)
+        return;
+
+      const std::size_t table_size
+      { alphabet.new_freq_table().size() };
+      const std::integral_constant<unsigned,0> depth
+      { };
+      auto extractor = [depth](const elem_type &tri) { return trichar(tri,depth); };
+
+      /* Frequencies of the first character, counted in parallel. */
+      portions text_portions
+      { from, to, num_threads };
+      auto frqtab_futs = text_portions.apply
+          (from,to,make_freq_table<It,decltype(extractor),AlphabetType>,
+              extractor,alphabet);
+      freq_table_type counts
+      { alphabet.new_freq_table() };
+      for (auto &frqtab_fut : frqtab_futs)
+        AlphabetType::add_char_freq_table(counts,frqtab_fut.get(),text_portions.threads());
+
+      /* Move all elements into their first-character bucket. */
+      const std::vector<bucket_type> buckets
+      { permute_into_buckets<It,decltype(extractor),AlphabetType>(from,to,extractor,counts) };
+
+      /* Sort the buckets independently. */
+      portions bucket_portions
+      { 1 };
+      bucket_portions.set_scheduling(portions::scheduling::stealing);
+      bucket_portions.assign(buckets.begin(),buckets.end(),num_threads);
+      auto sort_futs = bucket_portions.apply(buckets.begin(),buckets.end(),
+          [from,&alphabet,table_size](BucketIt bucket, BucketIt bucket_end)
+          {
+            for ( ; bucket != bucket_end ; ++bucket)
+              msd_sort(from + bucket->_begin,from + bucket->_end,alphabet,table_size,
+                  std::integral_constant<unsigned,1>());
+          });
+      wait_for(sort_futs);
+    }
+
+    /**
+     * Index-based version of `sort_23trigrams()`: Generates the
+     * starting positions of the 2,3-trigrams of the text [from,to) and
+     * sorts them by the trigrams they start. The radix passes move only
+     * the positions and read the characters from the text, so the
+     * memory needed is two vectors of `Pos` rather than two vectors
+     * of trigrams. Use `TrigramMaker<...>::from_positions()` if the
+     * trigrams themselves are required afterwards.
+     */
+    template <typename TextIt, typename AlphabetType>
+    static std::vector<Pos> sort_23positions(
+        TextIt from, TextIt to, const AlphabetType &alphabet, unsigned num_threads)
+    {
+      std::vector<Pos> positions
+      { PositionMaker<Pos>::make_23positions(from,to,num_threads) };
+
+      /* Portions for threads. */
+      rlxutil::parallel::portions portions
+      { begin(positions), end(positions), num_threads };
+      /* Vector for intermediate results. */
+      std::vector<Pos> temp_vec(positions.size());
+      /* First pass. */
+      lsd_pass(positions,temp_vec,
+          [from](const Pos pos) { return static_cast<Char>(*std::next(from,pos + 2)); },
+          alphabet,portions);
+      /* Second pass. */
+      lsd_pass(positions,temp_vec,
+          [from](const Pos pos) { return static_cast<Char>(*std::next(from,pos + 1)); },
+          alphabet,portions);
+      /* Third pass. */
+      lsd_pass(positions,temp_vec,
+          [from](const Pos pos) { return static_cast<Char>(*std::next(from,pos)); },
+          alphabet,portions);
+
+      return positions;
     }
 
   };
@@ -468,16 +1136,28 @@ namespace sux {
 
   /**
    * Extract the 2,3-trigrams from a character sequence represented by two
-   * input iterators.
+   * input iterators. The iterators may refer to const characters.
    */
   template <typename Pos, TGImpl tgimpl = TGImpl::arraytuple, typename It>
-  typename TrigramMaker<tgimpl,rlxtype::deref<It>,Pos>::trigram_vec_type
+  typename TrigramMaker<tgimpl,typename std::remove_cv<rlxtype::deref<It>>::type,Pos>::trigram_vec_type
   extract_23trigrams(It from, It to)
   {
-    typedef rlxtype::deref<It> char_type;
+    typedef typename std::remove_cv<rlxtype::deref<It>>::type char_type;
     return TrigramMaker<tgimpl,char_type,Pos>::make_23trigrams(from,to);
   }
 
+  /**
+   * Extract the 2,3-trigrams from a character sequence represented by two
+   * random-access iterators, using the given number of parallel threads.
+   */
+  template <typename Pos, TGImpl tgimpl = TGImpl::arraytuple, typename It>
+  typename TrigramMaker<tgimpl,typename std::remove_cv<rlxtype::deref<It>>::type,Pos>::trigram_vec_type
+  extract_23trigrams(It from, It to, unsigned threads)
+  {
+    typedef typename std::remove_cv<rlxtype::deref<It>>::type char_type;
+    return TrigramMaker<tgimpl,char_type,Pos>::make_23trigrams(from,to,threads);
+  }
+
   /**
    * Assuming that the first argument is a random-access container
    * containing the 2,3-trigrams of a string, this sorts them
@@ -489,8 +1169,11 @@ namespace sux {
    * procedure will create another container of the same size
    * and same type as the given one. This wouldn't be possible if
    * only iterators were available.
+   *
+   * Use `sort_23trigrams<SortPolicy::msd_inplace>(...)` to sort
+   * in place instead, without the second container.
    */
-  template <typename Vector, typename AlphabetType>
+  template <SortPolicy policy = SortPolicy::lsd, typename Vector, typename AlphabetType>
   void sort_23trigrams(
       Vector &trigrams, const AlphabetType &alphabet, unsigned num_threads)
   {
@@ -499,7 +1182,22 @@ namespace sux {
     typedef typename trigram_type::char_type  char_type;
     typedef typename trigram_type::pos_type   pos_type;
 
-    TrigramSorter<char_type,pos_type>::sort_23trigrams(trigrams,alphabet,num_threads);
+    TrigramSorter<char_type,pos_type>::template sort_23trigrams<policy>(
+        trigrams,alphabet,num_threads);
+  }
+
+  /**
+   * Sort the starting positions of the 2,3-trigrams of the text [from,to)
+   * lexicographically by their trigrams, without creating the trigrams
+   * (see `TrigramSorter::sort_23positions()`). `from` and `to` must
+   * be random-access iterators.
+   */
+  template <typename Pos, typename It, typename AlphabetType>
+  std::vector<Pos> sort_23positions(
+      It from, It to, const AlphabetType &alphabet, unsigned num_threads)
+  {
+    typedef typename std::remove_cv<rlxtype::deref<It>>::type char_type;
+    return TrigramSorter<char_type,Pos>::sort_23positions(from,to,alphabet,num_threads);
   }
 
 }
@@ -8,7 +8,19 @@
 #ifndef MORE_ALGORITHM_HPP_
 #define MORE_ALGORITHM_HPP_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "more_type_traits.hpp"
+#include "parallelization.hpp"
+#include "../sux/alphabet.hpp"
 
 namespace rlxutil {
   namespace algorithm {
@@ -71,6 +83,145 @@ namespace rlx {
       }
     }
 
+    /**
+     * Parameters of the write-combining scatter kernel used by
+     * `buffered_bucket_sort()`.
+     */
+    struct write_combining
+    {
+      /** Size of the staging buffer of each bucket (four cache lines). */
+      static constexpr std::size_t buffer_bytes = 256;
+      /** Ranges shorter than this are scattered directly. */
+      static constexpr std::size_t min_elements = 1 << 16;
+      /** With more buckets, the buffers no longer fit into the cache. */
+      static constexpr std::size_t max_buckets  = 4096;
+    };
+
+    /**
+     * Copy `num` elements from `src` to `dest`. Where possible (trivially
+     * copyable elements, 16-byte aligned destination and SSE2 available),
+     * non-temporal stores are used, so the destination does not pollute
+     * the cache.
+     */
+    template <typename Elem, typename DestIt>
+    void flush_block(const Elem *src, std::size_t num, DestIt dest)
+    {
+#if defined(__SSE2__)
+      if (num > 0
+          && (std::is_same<DestIt,Elem *>::value
+              || std::is_same<DestIt,typename std::vector<Elem>::iterator>::value))
+        {
+          void *dest_ptr = &*dest;
+          const std::size_t bytes = num * sizeof(Elem);
+          if (std::is_trivially_copyable<Elem>::value
+              && (reinterpret_cast<std::uintptr_t>(dest_ptr) % 16 == 0)
+              && (bytes % 16 == 0))
+            {
+              const __m128i *from = reinterpret_cast<const __m128i *>(src);
+              __m128i       *to   = reinterpret_cast<__m128i *>(dest_ptr);
+              for (std::size_t i = 0 ; i < bytes / 16 ; ++i)
+                _mm_stream_si128(to + i,_mm_loadu_si128(from + i));
+              return;
+            }
+        }
+#endif
+      std::copy(src,src + num,dest);
+    }
+
+    /**
+     * Bucket sort (see `bucket_sort()`) using software write-combining:
+     * Elements are first staged in a small buffer per bucket, and each
+     * buffer is written to the destination as a block once it is full.
+     * This keeps the number of destination cache lines and pages
+     * touched at any time small, even with many buckets.
+     *
+     * The cumulative frequency table must be a random-access sequence
+     * of write offsets (i.e. provide `begin()` and `size()`), and
+     * `bucket_index(key)` must return the position of a key in it.
+     */
+    template <typename It, typename DestIt, typename Extractor,
+              typename CumulFreqTable, typename BucketIndex>
+    void buffered_bucket_sort(
+        It from, It to, DestIt dest_from, Extractor extractor, CumulFreqTable &bucket_sizes,
+        BucketIndex bucket_index)
+    {
+      typedef typename std::remove_cv<rlxtype::deref<It>>::type elem_type;
+
+      const std::size_t num_buckets
+      { bucket_sizes.size() };
+      const std::size_t per_buffer
+      { sizeof(elem_type) >= write_combining::buffer_bytes ?
+          1 : write_combining::buffer_bytes / sizeof(elem_type) };
+
+      auto offsets = bucket_sizes.begin();
+      std::vector<elem_type>   buffers(num_buckets * per_buffer);
+      std::vector<std::size_t> fill(num_buckets);
+
+      while (from != to)
+        {
+          const std::size_t bucket
+          { static_cast<std::size_t>(bucket_index(extractor(*from))) };
+          elem_type *buffer = buffers.data() + bucket * per_buffer;
+          buffer[fill[bucket]++] = *from;
+          if (fill[bucket] == per_buffer)
+            {
+              flush_block(buffer,per_buffer,dest_from + offsets[bucket]);
+              offsets[bucket] += per_buffer;
+              fill[bucket] = 0;
+            }
+          ++from;
+        }
+
+      /* Remaining, partially filled buffers. */
+      for (std::size_t bucket = 0 ; bucket < num_buckets ; ++bucket)
+        if (fill[bucket] != 0)
+          {
+            std::copy(buffers.data() + bucket * per_buffer,
+                buffers.data() + bucket * per_buffer + fill[bucket],
+                dest_from + offsets[bucket]);
+            offsets[bucket] += fill[bucket];
+          }
+
+#if defined(__SSE2__)
+      /* Make the non-temporal stores visible to other threads. */
+      _mm_sfence();
+#endif
+    }
+
+    template <typename AlphabetType, typename It, typename DestIt, typename Extractor>
+    void bucket_sort_dispatch(
+        It from, It to, DestIt dest_from, Extractor extractor,
+        typename AlphabetType::freq_table_type &bucket_sizes, std::false_type)
+    { bucket_sort(from,to,dest_from,extractor,bucket_sizes); }
+
+    template <typename AlphabetType, typename It, typename DestIt, typename Extractor>
+    void bucket_sort_dispatch(
+        It from, It to, DestIt dest_from, Extractor extractor,
+        typename AlphabetType::freq_table_type &bucket_sizes, std::true_type)
+    {
+      if ((static_cast<std::size_t>(std::distance(from,to)) >= write_combining::min_elements)
+          && (bucket_sizes.size() <= write_combining::max_buckets))
+        buffered_bucket_sort(from,to,dest_from,extractor,bucket_sizes,
+            &AlphabetType::bucket_index);
+      else
+        bucket_sort(from,to,dest_from,extractor,bucket_sizes);
+    }
+
+    /**
+     * Bucket sort that selects the scatter kernel automatically: The
+     * write-combining kernel is used for large ranges if the alphabet's
+     * frequency tables are indexed arrays of moderate size; otherwise
+     * the elements are scattered directly.
+     */
+    template <typename AlphabetType, typename It, typename DestIt, typename Extractor>
+    void auto_bucket_sort(
+        It from, It to, DestIt dest_from, Extractor extractor,
+        typename AlphabetType::freq_table_type &bucket_sizes)
+    {
+      bucket_sort_dispatch<AlphabetType>(from,to,dest_from,extractor,bucket_sizes,
+          std::integral_constant<bool,AlphabetType::indexed_freq_table>());
+    }
+
     template <typename Compare, typename It1, typename It2>
     constexpr bool is_comparator()
     {
@@ -85,15 +236,24 @@ namespace rlx {
 
       return (traits::arity == 2
           && is_integral<result>::value
-          && is_same<decay<arg0>,decay<deref<It1>>>::value
-          && is_same<decay<arg1>,decay<deref<It2>>>::value);
+          && is_same<typename decay<arg0>::type,typename decay<deref<It1>>::type>::value
+          && is_same<typename decay<arg1>::type,typename decay<deref<It2>>::type>::value);
     }
 
-    template <typename It1, typename It2, typename DestIt, typename Compare>
+    /**
+     * Merge the sorted ranges [from1,to1) and [from2,to2) into the
+     * range starting at `dest_from`. `compare(elem1,elem2)` takes an
+     * element of the first range and one of the second range, and returns
+     * true if `elem1` comes first. The elements are written to the
+     * destination as `proj1(elem1)` and `proj2(elem2)`, respectively.
+     */
+    template <typename It1, typename It2, typename DestIt, typename Compare,
+              typename Proj1, typename Proj2>
     void merge_sorted(
-        It1 from1, It1 to1, It2 from2, It2 to2, DestIt dest_from, Compare &&compare)
+        It1 from1, It1 to1, It2 from2, It2 to2, DestIt dest_from, Compare &&compare,
+        Proj1 proj1, Proj2 proj2)
     {
-      static_assert(is_comparator<Compare,It1,It2>,
+      static_assert(is_comparator<typename std::remove_reference<Compare>::type,It1,It2>(),
           "Attempt to use merge_sorted() with an invalid comparator function");
 
       std::size_t pos
@@ -102,14 +262,53 @@ namespace rlx {
       while (from1 != to1 && from2 != to2)
         {
           if (compare(*from1,*from2))
-              *(dest_from + pos++) = *(from1++);
+              *(dest_from + pos++) = proj1(*(from1++));
           else
-            *(dest_from + pos++) = *(from2++);
+            *(dest_from + pos++) = proj2(*(from2++));
         }
       while (from1 != to1)
-        *(dest_from + pos++) = *(from1++);
+        *(dest_from + pos++) = proj1(*(from1++));
       while (from2 != to2)
-        *(dest_from + pos++) = *(from2++);
+        *(dest_from + pos++) = proj2(*(from2++));
+    }
+
+    template <typename It1, typename It2, typename DestIt, typename Compare>
+    void merge_sorted(
+        It1 from1, It1 to1, It2 from2, It2 to2, DestIt dest_from, Compare &&compare)
+    {
+      typedef rlxtype::deref<It1> elem1_type;
+      typedef rlxtype::deref<It2> elem2_type;
+      merge_sorted(from1,to1,from2,to2,dest_from,std::forward<Compare>(compare),
+          [](const elem1_type &elem) -> const elem1_type & { return elem; },
+          [](const elem2_type &elem) -> const elem2_type & { return elem; });
+    }
+
+    /**
+     * Given the sorted ranges [from1,from1+len1) and [from2,from2+len2),
+     * determine how many of the first `diag` elements of their merge
+     * (as performed by `merge_sorted()`) come from the first range. This
+     * is a binary search along the cross diagonal `diag` of the "merge
+     * path".
+     */
+    template <typename It1, typename It2, typename Compare>
+    std::size_t merge_path_split(
+        It1 from1, std::size_t len1, It2 from2, std::size_t len2, std::size_t diag,
+        Compare &compare)
+    {
+      std::size_t lo
+      { diag > len2 ? diag - len2 : 0 };
+      std::size_t hi
+      { diag < len1 ? diag : len1 };
+      while (lo < hi)
+        {
+          const std::size_t mid
+          { lo + (hi - lo) / 2 };
+          if (compare(*(from1 + mid),*(from2 + (diag - mid - 1))))
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+      return lo;
     }
 
   }
@@ -148,43 +347,21 @@ namespace rlx {
       auto frqtab_vec = portions.apply
           (from,to,make_freq_table<freq_table_type,It,Extractor>,extractor);
 
-      /* Initialise cumulative frequencies per thread. This will
-       * be filled with the correct values later. */
+      /* Move the thread-local frequency tables out of their
+       * futures. */
       std::vector<freq_table_type> cumul_frqtab_vec
       { };
-
-      /* Total frequency, for each character. */
-      freq_table_type cumul_frqtab
-      { };
       for (auto &frqtab_fut : frqtab_vec)
-      {
-        /* Move the thread-local frequency table out
-         * of its future. */
-        freq_table_type frqtab
-        { frqtab_fut.get() };
-        /* Add its character frequencies to the total table. */
-        alphabet_type::add_char_freq_table(cumul_frqtab,frqtab,portions.num());
-        /* Move thread-local frequency table to the end of the
-         * thread-local cumulative frequency table list. Note
-         * that the frequencies are not really cumulative yet;
-         * this will be corrected later. */
-        cumul_frqtab_vec.push_back(std::move(frqtab));
-      }
+        cumul_frqtab_vec.push_back(frqtab_fut.get());
 
-      /* Cumulate the entries of the global frequency table. */
-      alphabet_type::make_cumulative(cumul_frqtab);
-
-      /* Correct the cumulative thread-local frequencies. */
-      for (freq_table_type &frqtab : cumul_frqtab_vec) {
-        /* Swap with current version of global cumulative
-         * frequency table. */
-        std::swap(cumul_frqtab,frqtab);
-        alphabet_type::add_char_freq_table(cumul_frqtab,frqtab,portions.num());
-      }
+      /* Turn them into thread-local cumulative frequencies, i.e. the
+       * position where each thread writes the next element of each
+       * bucket. */
+      alphabet_type::make_cumulative(cumul_frqtab_vec,portions.threads());
 
       /* Radix-sorting threads. */
       auto sort_fut_vec = portions.apply_dynargs
-          (from,to,seqalgo::bucket_sort<It,It,Extractor,freq_table_type>,
+          (from,to,seqalgo::auto_bucket_sort<alphabet_type,It,It,Extractor>,
            arg_generator(
                [&cumul_frqtab_vec,dest,&extractor](int thread)
            { return make_tuple(dest,extractor,ref(cumul_frqtab_vec[thread])); })
@@ -193,6 +370,78 @@ namespace rlx {
       wait_for(sort_fut_vec);
     }
 
+    /**
+     * Parallel version of `seqalgo::merge_sorted()`. The destination
+     * range is divided by `portions`, which must have been assigned to
+     * the destination range (of length `(to1-from1) + (to2-from2)`).
+     * For each portion, the corresponding parts of the two input ranges
+     * are determined by a binary search along the merge path, and all
+     * portions are merged concurrently. The result is identical to that
+     * of the sequential merge.
+     */
+    template <typename It1, typename It2, typename DestIt, typename Compare,
+              typename Proj1, typename Proj2>
+    void merge_sorted(
+        It1 from1, It1 to1, It2 from2, It2 to2, DestIt dest_from, Compare &&compare,
+        const rlxutil::parallel::portions &portions, Proj1 proj1, Proj2 proj2)
+    {
+      using std::distance;
+      using rlxutil::parallel::tools::wait_for;
+
+      const std::size_t len1
+      { static_cast<std::size_t>(distance(from1,to1)) };
+      const std::size_t len2
+      { static_cast<std::size_t>(distance(from2,to2)) };
+
+      auto futs = portions.apply(dest_from,dest_from + (len1 + len2),
+          [=,&compare](DestIt out_from, DestIt out_to)
+          {
+            const std::size_t diag_from
+            { static_cast<std::size_t>(distance(dest_from,out_from)) };
+            const std::size_t diag_to
+            { static_cast<std::size_t>(distance(dest_from,out_to)) };
+            const std::size_t split_from
+            { seqalgo::merge_path_split(from1,len1,from2,len2,diag_from,compare) };
+            const std::size_t split_to
+            { seqalgo::merge_path_split(from1,len1,from2,len2,diag_to,compare) };
+            seqalgo::merge_sorted(
+                from1 + split_from,from1 + split_to,
+                from2 + (diag_from - split_from),from2 + (diag_to - split_to),
+                out_from,compare,proj1,proj2);
+          });
+      wait_for(futs);
+    }
+
+    /**
+     * Parallel version of `seqalgo::merge_sorted()`, using `threads`
+     * parallel threads.
+     */
+    template <typename It1, typename It2, typename DestIt, typename Compare,
+              typename Proj1, typename Proj2>
+    void merge_sorted(
+        It1 from1, It1 to1, It2 from2, It2 to2, DestIt dest_from, Compare &&compare,
+        unsigned threads, Proj1 proj1, Proj2 proj2)
+    {
+      const DestIt dest_to
+      { dest_from + (std::distance(from1,to1) + std::distance(from2,to2)) };
+      rlxutil::parallel::portions portions
+      { dest_from, dest_to, threads };
+      merge_sorted(from1,to1,from2,to2,dest_from,std::forward<Compare>(compare),
+          portions,proj1,proj2);
+    }
+
+    template <typename It1, typename It2, typename DestIt, typename Compare>
+    void merge_sorted(
+        It1 from1, It1 to1, It2 from2, It2 to2, DestIt dest_from, Compare &&compare,
+        unsigned threads)
+    {
+      typedef rlxtype::deref<It1> elem1_type;
+      typedef rlxtype::deref<It2> elem2_type;
+      merge_sorted(from1,to1,from2,to2,dest_from,std::forward<Compare>(compare),threads,
+          [](const elem1_type &elem) -> const elem1_type & { return elem; },
+          [](const elem2_type &elem) -> const elem2_type & { return elem; });
+    }
+
   } // paralgo
 
 } // rlx
@@ -16,9 +16,13 @@
 #include <stdexcept>
 #include <string>
 #include <iterator>
+#include <algorithm>
+#include <numeric>
+#include <future>
 
 #include "more_type_traits.hpp"
 #include "tupletools.hpp"
+#include "thread_pool.hpp"
 
 namespace rlxutil {
 
@@ -143,17 +147,42 @@ namespace rlxutil {
       struct is_boundary_adjuster<int,Arg>
       { static constexpr bool value = false; };
 
+      /**
+       * How the portions are mapped to threads.
+       *
+       * `per_thread` is the default: the range is cut into one portion
+       * per thread, and each portion is processed by one thread.
+       *
+       * `stealing` cuts the range into `tasks_per_thread` times as many,
+       * smaller portions. They are distributed among the threads in
+       * contiguous blocks, and a thread that has finished its own block
+       * takes (steals) portions from the blocks of other threads. This
+       * compensates for portions of uneven size, e.g. as a result of
+       * boundary adjustments.
+       *
+       * Both `apply()` and `apply_dynargs()` return one future per
+       * portion, in the order of the portions, in either mode.
+       */
+      enum class scheduling : bool
+      { per_thread , stealing };
+
       portions(unsigned min_portion_size = 10000) :
         _min_portion_size(static_cast<diff_t>(min_portion_size)),
         _offsets(),
-        _total_range()
+        _total_range(),
+        _threads(0),
+        _scheduling(scheduling::per_thread),
+        _tasks_per_thread(1)
       { }
 
       template <typename It>
       portions(It start, It end, std::size_t num_portions, diff_t min_portion_size = 10000) :
         _min_portion_size(static_cast<diff_t>(min_portion_size)),
         _offsets(),
-        _total_range(std::distance(start,end))
+        _total_range(std::distance(start,end)),
+        _threads(0),
+        _scheduling(scheduling::per_thread),
+        _tasks_per_thread(1)
       { assign(start,end,num_portions); }
 
       template <typename It, typename BoundAdjust>
@@ -163,9 +192,32 @@ namespace rlxutil {
           typename std::enable_if<is_boundary_adjuster<BoundAdjust,It>::value,unsigned>::type = 0) :
         _min_portion_size(min_portion_size),
         _offsets(),
-        _total_range(std::distance(start,end))
+        _total_range(std::distance(start,end)),
+        _threads(0),
+        _scheduling(scheduling::per_thread),
+        _tasks_per_thread(1)
       { assign(start,end,num_portions,std::forward<BoundAdjust>(boundary_adjuster)); }
 
+      /**
+       * Select the scheduling mode. This takes effect at the next
+       * call to `assign()`.
+       * @param mode `scheduling::per_thread` or `scheduling::stealing`
+       * @param tasks_per_thread The number of portions created per thread
+       *   in stealing mode. Ignored in per-thread mode.
+       */
+      void set_scheduling(scheduling mode, std::size_t tasks_per_thread = 16)
+      {
+        _scheduling       = mode;
+        _tasks_per_thread =
+            (mode == scheduling::stealing && tasks_per_thread > 0 ? tasks_per_thread : 1);
+      }
+
+      /**
+       * Return the scheduling mode currently selected.
+       */
+      scheduling mode() const
+      { return _scheduling; }
+
       /**
        * Calculate the start and end offsets for `num` portions of a range of
        * values. If no boundary adjustment is enabled (final argument nullptr),
@@ -190,37 +242,46 @@ namespace rlxutil {
         /* The number of threads becomes a signed integer here.
          * From here on, all integer operations related to the
          * number and size of portions are signed. */
-        const diff_t num = static_cast<diff_t>(num_threads);
+        diff_t num = static_cast<diff_t>(num_threads);
 
         /* Sanity. */
         if (num < 1)
-          assign(range_from,range_to,1,forward<BoundAdjust>(boundary_adjuster));
+          num = 1;
         /* Make sure we don't create too many threads. The
          * initialization below involves casting from unsigned
          * to signed. */
         const diff_t total
         { distance(range_from,range_to) };
         if ((num > 1) && (total/num < _min_portion_size))
-          assign(
-              range_from,range_to,
-              ((total / _min_portion_size == 0) ? 1 : (total / _min_portion_size)),
-              forward<BoundAdjust>(boundary_adjuster));
+          num = ((total / _min_portion_size == 0) ? 1 : (total / _min_portion_size));
+        _threads = static_cast<std::size_t>(num);
+
+        /* In stealing mode, each thread gets several portions, but
+         * no portion is empty from the start. */
+        num *= static_cast<diff_t>(_tasks_per_thread);
+        if (num > total)
+          num = (total == 0 ? 1 : total);
 
         /* Calculate boundaries, using the adjustment function if any
          * was given by the caller. */
-        if (boundary_adjuster == nullptr)
-          calculate_boundaries(range_from,range_to,num,nullptr);
-        else
-          calculate_boundaries(range_from,range_to,num,forward<BoundAdjust>(boundary_adjuster));
+        calculate_boundaries(range_from,range_to,num,forward<BoundAdjust>(boundary_adjuster));
 
         /* Update total-range value. */
-        _total_range = std::accumulate(_offsets.begin(),_offsets.end(),0,
+        _total_range = std::accumulate(_offsets.begin(),_offsets.end(),diff_t(0),
             [](diff_t t, const pair<diff_t,diff_t> &p) { return t + (p.second - p.first); });
 
         /* Paranoia. */
         assert(distance(range_from,range_to) == _total_range);
       }
 
+      /**
+       * Return the number of threads used by `apply()` and
+       * `apply_dynargs()`. In per-thread mode, this is the number
+       * of portions before boundary adjustment.
+       */
+      std::size_t threads() const
+      { return _threads; }
+
       /**
        * Return the number of portions currently maintained.
        */
@@ -249,6 +310,9 @@ namespace rlxutil {
        * @return A vector of futures. The threads may still be running when
        *   the vector is returned. Use `get()` to access each result
        *   (which may imply waiting for the corresponding thread to finish).
+       *   The portions are processed by the workers of `default_pool()`,
+       *   so the futures do not wait in their destructor. Use `get()` or
+       *   `tools::wait_for()` before discarding them.
        */
       template <typename It, typename Fun, typename... Args>
       std::vector<typename std::future<typename std::result_of<Fun(It,It,Args...)>::type>>
@@ -257,7 +321,6 @@ namespace rlxutil {
         using std::pair;
         using std::vector;
         using std::future;
-        using std::async;
         using std::forward;
 
         typedef typename std::result_of<Fun(It,It,Args...)>::type result_type;
@@ -270,13 +333,28 @@ namespace rlxutil {
         DLOG(INFO) << "Running parallel_perform without generator, using "
             << _offsets.size() << " threads";
 
+        thread_pool &pool = default_pool();
+
+        if (_scheduling == scheduling::stealing)
+          {
+            vector<std::function<result_type()>> tasks
+            { };
+            tasks.reserve(_offsets.size());
+            for (const pair<diff_t,diff_t> &os : _offsets)
+              tasks.emplace_back(std::bind(fun,(from + os.first),(from + os.second),args...));
+            return pool.submit_stealing(std::move(tasks),_threads);
+          }
+
+        pool.reserve(_offsets.size());
+
         vector<future<result_type>> results
         { };
+        results.reserve(_offsets.size());
 
         for (const pair<diff_t,diff_t> &os : _offsets)
           {
             future<result_type> fut
-            { async(std::launch::async,
+            { pool.submit(
                 forward<Fun>(fun),(from + os.first),(from + os.second),forward<Args>(args)...) };
             results.push_back(std::move(fut));
           }
@@ -300,6 +378,9 @@ namespace rlxutil {
        * @return A vector of futures. The threads may still be running when
        *   the vector is returned. Use `get()` to access each result
        *   (which may imply waiting for the corresponding thread to finish).
+       *   The portions are processed by the workers of `default_pool()`,
+       *   so the futures do not wait in their destructor. Use `get()` or
+       *   `tools::wait_for()` before discarding them.
        */
       template <typename It, typename Fun, typename Generator>
       typename std::enable_if<tools::is_arg_generator<Generator>::value,
@@ -309,7 +390,6 @@ namespace rlxutil {
         using std::pair;
         using std::vector;
         using std::future;
-        using std::async;
         using std::forward;
         using rlxutil::call_on_tuple;
         using std::make_tuple;
@@ -325,19 +405,41 @@ namespace rlxutil {
         DLOG(INFO) << "Running parallel_perform with generator, using "
             << _offsets.size() << " threads";
 
+        thread_pool &pool = default_pool();
+
+        if (_scheduling == scheduling::stealing)
+          {
+            vector<std::function<result_type()>> tasks
+            { };
+            tasks.reserve(_offsets.size());
+            std::size_t counter = 0;
+            for (const pair<diff_t,diff_t> &os : _offsets)
+              {
+                auto args = tuple_cat(make_tuple((from + os.first),(from + os.second)),gen(counter));
+                tasks.emplace_back([fun,args]() { return call_on_tuple(fun,args); });
+                ++counter;
+              }
+            return pool.submit_stealing(std::move(tasks),_threads);
+          }
+
+        pool.reserve(_offsets.size());
+
         vector<future<result_type>> results
         { };
+        results.reserve(_offsets.size());
 
         std::size_t counter = 0;
         for (const pair<diff_t,diff_t> &os : _offsets)
           {
+            /* The arguments are generated here, rather than inside the task,
+             * and the task keeps its own copy of `fun`, because both `gen`
+             * and (possibly) `fun` go out of scope when we return. */
+            auto args = tuple_cat(make_tuple((from + os.first),(from + os.second)),gen(counter));
             future<result_type> fut
             {
-              async(std::launch::async,
-                  [from,os,counter,&fun,&gen]()
-                  {
-                call_on_tuple(fun,tuple_cat(make_tuple((from + os.first),(from + os.second)),gen(counter)));
-                  })
+              pool.submit(
+                  [fun,args]()
+                  { return call_on_tuple(fun,args); })
             };
             results.push_back(std::move(fut));
             ++counter;
@@ -355,6 +457,13 @@ namespace rlxutil {
       std::vector<std::pair<diff_t,diff_t>>  _offsets;
       /** The total number of items covered by the portions. */
       diff_t                                 _total_range;
+      /** The number of threads the portions are processed by. */
+      std::size_t                            _threads;
+      /** Scheduling mode. */
+      scheduling                             _scheduling;
+      /** Number of portions per thread (greater than 1 only in
+       * stealing mode). */
+      std::size_t                            _tasks_per_thread;
 
       /**
        * Calculate portion boundaries and re-adjust them with the user-defined
@@ -390,7 +499,7 @@ namespace rlxutil {
            * Note: The below involves a cast from signed (difference_type) to
            * unsigned. */
           diff_t remainder = distance(portion_start,range_to);
-          if (remainder < portion)
+          if (remainder <= portion)
             portion_end = range_to;
           else
             {
@@ -398,7 +507,8 @@ namespace rlxutil {
               while ((portion_end != range_to)
                   && (boundary_adjuster(range_from,portion_end,range_to) == adjustment::needed))
                 ++portion_end;
-              ++portion_end;
+              if (portion_end != range_to)
+                ++portion_end;
             }
           return make_pair(
               distance(range_from,portion_start),
@@ -411,6 +521,8 @@ namespace rlxutil {
             std::find_if(_offsets.rbegin(),_offsets.rend(),[](const pair<diff_t,diff_t> &p)
                 { return (p.first != p.second); });
         _offsets.erase(last_non_empty.base(),_offsets.end());
+        if (_offsets.empty())
+          _offsets.emplace_back(0,0);
 
         _offsets.back().second = distance(range_from,range_to);
       }
@@ -0,0 +1,193 @@
+/*
+ * parallelization_test.cpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ParallelizationTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <thread>
+#include <random>
+#include <utility>
+#include <glog/logging.h>
+
+#include "../parallelization.hpp"
+#include "../thread_pool.hpp"
+#include "../more_algorithm.hpp"
+
+BOOST_AUTO_TEST_CASE(parallelization_thread_pool_submit)
+{
+  rlxutil::parallel::thread_pool pool
+  { 3 };
+  BOOST_CHECK(pool.size() == 3);
+
+  std::vector<std::future<int>> futs;
+  for (int i = 0 ; i < 100 ; ++i)
+    futs.push_back(pool.submit([](int a, int b) { return a * b; },i,2));
+
+  for (int i = 0 ; i < 100 ; ++i)
+    BOOST_CHECK(futs[i].get() == 2 * i);
+
+  /* Exceptions thrown by a task are delivered through its future. */
+  auto fut = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+  BOOST_CHECK_THROW(fut.get(),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(parallelization_thread_pool_reuse)
+{
+  using rlxutil::parallel::default_pool;
+  using rlxutil::parallel::portions;
+  using rlxutil::parallel::tools::wait_for;
+  typedef std::vector<int>::iterator It;
+
+  std::vector<int> vec(100000);
+  std::iota(begin(vec),end(vec),0);
+
+  portions ps
+  { begin(vec) , end(vec) , 4 , 100 };
+
+  /* Repeated application of the same portions object must
+   * not create additional worker threads. */
+  std::size_t pool_size
+  { 0 };
+  for (int round = 0 ; round < 20 ; ++round)
+    {
+      auto futs = ps.apply(begin(vec),end(vec),
+          [](It from, It to) { return std::accumulate(from,to,0L); });
+      long total
+      { 0 };
+      for (auto &fut : futs)
+        total += fut.get();
+      BOOST_CHECK(total == 100000L * 99999L / 2);
+
+      if (round == 0)
+        pool_size = default_pool().size();
+      BOOST_CHECK(default_pool().size() == pool_size);
+    }
+
+  /* Nested use of portions from within a worker. */
+  auto futs = ps.apply(begin(vec),end(vec),
+      [](It from, It to)
+      {
+        portions inner
+        { from , to , 2 , 10 };
+        auto inner_futs = inner.apply(from,to,[](It f, It t) { std::fill(f,t,1); });
+        wait_for(inner_futs);
+      });
+  wait_for(futs);
+  BOOST_CHECK(std::accumulate(begin(vec),end(vec),0) == 100000);
+}
+
+BOOST_AUTO_TEST_CASE(parallelization_work_stealing)
+{
+  using rlxutil::parallel::portions;
+  using rlxutil::parallel::tools::wait_for;
+  using rlxutil::parallel::tools::arg_generator;
+  typedef std::vector<int>::const_iterator It;
+  typedef portions::adjustment             adjustment;
+
+  /* Runs of identical values of increasing length. */
+  std::vector<int> vec;
+  for (int run = 0 ; vec.size() < 100000 ; ++run)
+    vec.insert(vec.end(),run * run,run);
+
+  portions ps
+  { 100 };
+  ps.set_scheduling(portions::scheduling::stealing,8);
+  ps.assign(vec.cbegin(),vec.cend(),4,
+      [](It /*beg*/, It it, It end)
+      {
+        It nx = std::next(it);
+        if ((nx != end) && (*it == *nx))
+          return adjustment::needed;
+        return adjustment::unneeded;
+      });
+
+  BOOST_CHECK(ps.threads() == 4);
+  BOOST_CHECK(ps.num() > 4);
+  BOOST_CHECK(ps.num() <= 32);
+
+  /* Portions are contiguous, and no run is split between portions. */
+  const auto &boundaries = ps.get_boundaries();
+  BOOST_CHECK(boundaries.front().first == 0);
+  BOOST_CHECK(boundaries.back().second == static_cast<portions::diff_t>(vec.size()));
+  for (std::size_t i = 1 ; i < boundaries.size() ; ++i)
+    {
+      BOOST_CHECK(boundaries[i-1].second == boundaries[i].first);
+      BOOST_CHECK(vec[boundaries[i].first - 1] != vec[boundaries[i].first]);
+    }
+
+  /* One future per portion, in the order of the portions. */
+  auto futs = ps.apply(vec.cbegin(),vec.cend(),
+      [](It from, It to) { return std::make_pair(*from,std::distance(from,to)); });
+  BOOST_CHECK(futs.size() == boundaries.size());
+  for (std::size_t i = 0 ; i < futs.size() ; ++i)
+    {
+      auto result = futs[i].get();
+      BOOST_CHECK(result.first == vec[boundaries[i].first]);
+      BOOST_CHECK(result.second == boundaries[i].second - boundaries[i].first);
+    }
+
+  /* Generated arguments are matched to the portions in order. */
+  std::vector<std::size_t> portion_of(vec.size());
+  auto dyn_futs = ps.apply_dynargs(vec.cbegin(),vec.cend(),
+      [&vec,&portion_of](It from, It to, std::size_t index)
+      {
+        while (from != to)
+          portion_of[std::distance(vec.cbegin(),from++)] = index;
+      },
+      arg_generator([](std::size_t portion) { return std::make_tuple(portion); }));
+  wait_for(dyn_futs);
+  for (std::size_t i = 0 ; i < boundaries.size() ; ++i)
+    BOOST_CHECK(portion_of[boundaries[i].first] == i && portion_of[boundaries[i].second - 1] == i);
+}
+
+BOOST_AUTO_TEST_CASE(parallelization_merge_sorted)
+{
+  typedef std::pair<int,int> elem_type;
+
+  /* Sorted inputs with many duplicates, both within and across the
+   * two sequences. The second member records the origin of each
+   * element so that the order of ties can be checked. */
+  std::mt19937 gen
+  { 42 };
+  std::uniform_int_distribution<int> dist
+  { 0 , 500 };
+
+  auto comparator = [](const elem_type &lhs, const int &rhs) { return lhs.first <= rhs; };
+  auto proj1      = [](const elem_type &elem) { return elem; };
+  auto proj2      = [](const int &elem) { return std::make_pair(elem,-1); };
+
+  for (std::size_t len1 : { 0 , 1 , 1000 , 50000 })
+    for (std::size_t len2 : { 0 , 1 , 777 , 60000 })
+      {
+        std::vector<elem_type> seq1;
+        std::vector<int>       seq2;
+        for (std::size_t i = 0 ; i < len1 ; ++i)
+          seq1.emplace_back(dist(gen),static_cast<int>(i));
+        for (std::size_t i = 0 ; i < len2 ; ++i)
+          seq2.push_back(dist(gen));
+        std::sort(begin(seq1),end(seq1));
+        std::sort(begin(seq2),end(seq2));
+
+        std::vector<elem_type> expected(len1 + len2);
+        rlx::seqalgo::merge_sorted(begin(seq1),end(seq1),begin(seq2),end(seq2),
+            begin(expected),comparator,proj1,proj2);
+        BOOST_CHECK(std::is_sorted(begin(expected),end(expected),
+            [](const elem_type &lhs, const elem_type &rhs) { return lhs.first < rhs.first; }));
+
+        for (unsigned threads = 1 ; threads <= 8 ; ++threads)
+          {
+            std::vector<elem_type> result(len1 + len2);
+            rlx::paralgo::merge_sorted(begin(seq1),end(seq1),begin(seq2),end(seq2),
+                begin(result),comparator,threads,proj1,proj2);
+            BOOST_CHECK(result == expected);
+          }
+      }
+}
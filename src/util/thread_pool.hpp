@@ -0,0 +1,290 @@
+/*
+ * thread_pool.hpp
+ *
+ *  Created on: 2026/10/16
+ *      Author: jogojapan
+ */
+
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+
+namespace rlxutil {
+
+  namespace parallel {
+
+    /**
+     * A set of long-lived worker threads that execute tasks taken from
+     * a shared queue. This is used by `portions` (and everything built on
+     * top of it) instead of starting fresh threads through `std::async`
+     * for every parallel step.
+     *
+     * Tasks submitted from within one of the workers are executed
+     * immediately by the submitting thread. This avoids deadlocks when
+     * a task itself uses `portions` and waits for the results.
+     *
+     * Note that, unlike futures obtained from `std::async`, the futures
+     * returned by `submit()` do not block in their destructor. Callers
+     * must wait for the results explicitly (e.g. using `tools::wait_for`)
+     * before any data used by the tasks goes out of scope.
+     */
+    class thread_pool
+    {
+    public:
+      typedef std::function<void()> task_type;
+
+      explicit thread_pool(std::size_t num_workers = default_size()) :
+        _mutex(),
+        _cond(),
+        _queue(),
+        _workers(),
+        _stopping(false)
+      { reserve(num_workers); }
+
+      thread_pool(const thread_pool &) = delete;
+      thread_pool &operator=(const thread_pool &) = delete;
+
+      ~thread_pool()
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _stopping = true;
+        }
+        _cond.notify_all();
+        for (std::thread &worker : _workers)
+          worker.join();
+      }
+
+      /**
+       * The number of worker threads used when the caller does not
+       * specify it: one per hardware thread, but at least one.
+       */
+      static std::size_t default_size()
+      {
+        const std::size_t hw = std::thread::hardware_concurrency();
+        return (hw == 0 ? 1 : hw);
+      }
+
+      /**
+       * Return the number of worker threads currently running.
+       */
+      std::size_t size() const
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _workers.size();
+      }
+
+      /**
+       * Make sure there are at least `num_workers` worker threads. The
+       * pool never shrinks; threads created here live until the pool
+       * is destroyed.
+       */
+      void reserve(std::size_t num_workers)
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        while (_workers.size() < num_workers)
+          _workers.emplace_back(&thread_pool::work,this);
+      }
+
+      /**
+       * Return true if the calling thread is a worker of any pool.
+       */
+      static bool is_worker()
+      { return worker_flag(); }
+
+      /**
+       * Schedule `fun(args...)` for execution by one of the workers.
+       * The arguments are copied (or moved) into the task, just as
+       * `std::async` would do it.
+       * @return A future that provides the result (or exception) of the call.
+       */
+      template <typename Fun, typename... Args>
+      std::future<typename std::result_of<Fun(Args...)>::type>
+      submit(Fun &&fun, Args&&... args)
+      {
+        typedef typename std::result_of<Fun(Args...)>::type result_type;
+        typedef std::packaged_task<result_type()>           packaged_type;
+
+        std::shared_ptr<packaged_type> task
+        { std::make_shared<packaged_type>(
+            std::bind(std::forward<Fun>(fun),std::forward<Args>(args)...)) };
+        std::future<result_type> result
+        { task->get_future() };
+
+        if (is_worker())
+          (*task)();
+        else
+          {
+            {
+              std::lock_guard<std::mutex> lock(_mutex);
+              _queue.emplace_back([task]() { (*task)(); });
+            }
+            _cond.notify_one();
+          }
+
+        return result;
+      }
+
+      /**
+       * Execute a list of tasks using work stealing: The tasks are
+       * distributed in contiguous blocks among `num_workers` workers.
+       * Each worker processes its own block from the front. When it is
+       * done, it takes tasks from the back of the blocks of the other
+       * workers, until no task is left.
+       * @return One future per task, in the order of `tasks`.
+       */
+      template <typename Result>
+      std::vector<std::future<Result>>
+      submit_stealing(std::vector<std::function<Result()>> tasks, std::size_t num_workers)
+      {
+        typedef std::packaged_task<Result()> packaged_type;
+
+        const std::size_t num_tasks
+        { tasks.size() };
+        if (num_workers > num_tasks)
+          num_workers = num_tasks;
+        if (num_workers == 0)
+          num_workers = 1;
+
+        std::shared_ptr<stealing_state> state
+        { std::make_shared<stealing_state>(num_workers) };
+
+        std::vector<std::future<Result>> results
+        { };
+        results.reserve(num_tasks);
+        for (std::size_t i = 0 ; i < num_tasks ; ++i)
+          {
+            std::shared_ptr<packaged_type> task
+            { std::make_shared<packaged_type>(std::move(tasks[i])) };
+            results.push_back(task->get_future());
+            state->_queues[i * num_workers / num_tasks]._tasks.emplace_back(
+                [task]() { (*task)(); });
+          }
+
+        reserve(num_workers);
+        for (std::size_t worker = 0 ; worker < num_workers ; ++worker)
+          submit(&stealing_state::work,state,worker);
+
+        return results;
+      }
+
+    private:
+      /**
+       * Task queues shared by the workers of one call to
+       * `submit_stealing()`.
+       */
+      struct stealing_state
+      {
+        struct queue
+        {
+          std::mutex            _mutex;
+          std::deque<task_type> _tasks;
+        };
+
+        std::vector<queue> _queues;
+
+        explicit stealing_state(std::size_t num_workers) :
+          _queues(num_workers)
+        { }
+
+        bool take(std::size_t index, task_type &task, bool own)
+        {
+          queue &q = _queues[index];
+          std::lock_guard<std::mutex> lock(q._mutex);
+          if (q._tasks.empty())
+            return false;
+          if (own)
+            {
+              task = std::move(q._tasks.front());
+              q._tasks.pop_front();
+            }
+          else
+            {
+              task = std::move(q._tasks.back());
+              q._tasks.pop_back();
+            }
+          return true;
+        }
+
+        void work(std::size_t worker)
+        {
+          const std::size_t num_queues
+          { _queues.size() };
+          task_type task;
+          for (;;)
+            {
+              bool found
+              { take(worker,task,true) };
+              for (std::size_t i = 1 ; !found && i < num_queues ; ++i)
+                found = take((worker + i) % num_queues,task,false);
+              if (!found)
+                return;
+              task();
+            }
+        }
+      };
+
+      mutable std::mutex       _mutex;
+      std::condition_variable  _cond;
+      std::deque<task_type>    _queue;
+      std::vector<std::thread> _workers;
+      bool                     _stopping;
+
+      static bool &worker_flag()
+      {
+        static thread_local bool flag
+        { false };
+        return flag;
+      }
+
+      /**
+       * Main loop of each worker thread. Tasks remaining in the queue
+       * when the pool is destroyed are still executed.
+       */
+      void work()
+      {
+        worker_flag() = true;
+        for (;;)
+          {
+            task_type task;
+            {
+              std::unique_lock<std::mutex> lock(_mutex);
+              _cond.wait(lock,[this]() { return (_stopping || !_queue.empty()); });
+              if (_queue.empty())
+                return;
+              task = std::move(_queue.front());
+              _queue.pop_front();
+            }
+            task();
+          }
+      }
+    };
+
+    /**
+     * The process-wide thread pool shared by all parallel algorithms.
+     * It is created on first use.
+     */
+    inline thread_pool &default_pool()
+    {
+      static thread_pool pool
+      { };
+      return pool;
+    }
+
+  }
+
+}
+
+
+#endif /* THREAD_POOL_HPP_ */